@@ -0,0 +1,11 @@
+@echo off
+REM Build script for the microbenchmarks
+REM Run from the repository root; produces bench\ccal_bench.exe
+REM Extra arguments are passed to gcc, e.g. bench\build_bench.bat -DUSE_EMBEDDED_RULES
+REM after running build_rules.bat to also time the embedded rule loader
+
+echo Compiling bench\ccal_bench.exe...
+gcc -O2 -DCCAL_LIBRARY %* bench\ccal_bench.c ccal.c modules\converter.c -o bench\ccal_bench.exe || exit /b 1
+
+echo.
+echo Done! Run bench\ccal_bench.exe --json results.json --baseline bench\baseline.json
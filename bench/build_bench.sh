@@ -0,0 +1,11 @@
+#!/bin/bash
+# Build script for the microbenchmarks
+# Run from the repository root; produces bench/ccal_bench
+# Extra arguments are passed to gcc, e.g. ./bench/build_bench.sh -DUSE_EMBEDDED_RULES
+# after running build_rules.sh to also time the embedded rule loader
+
+echo "Compiling bench/ccal_bench..."
+gcc -O2 -DCCAL_LIBRARY "$@" bench/ccal_bench.c ccal.c modules/converter.c -o bench/ccal_bench -lm || exit 1
+
+echo ""
+echo "Done! Run ./bench/ccal_bench --json results.json --baseline bench/baseline.json"
@@ -0,0 +1,682 @@
+// bench/ccal_bench.c
+// Microbenchmarks for the calculator's hot paths
+// Links the evaluator and the converter directly and times the functions
+// the command line tool and the GUI call per expression, over corpora
+// generated from a fixed seed so runs on different days see the same input
+// Reports ns/op, throughput and allocations per operation, writes them as
+// JSON and compares them against a stored baseline
+// Build with bench/build_bench.sh (or build_bench.bat) from the repository root
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+#include "../ccal.h"
+#include "../remove_format.h"
+#include "../modules/converter.h"
+
+// Legacy entry points of ccal.c, declared here as ccal_gui.c does
+extern double evaluate_expr_string(const char* expr, int* error);
+extern double evaluate(int argc, char* argv[], int* error);
+
+// Expressions in each generated corpus
+#define BENCH_CORPUS 4096
+
+// Longest generated expression, and most tokens in one
+#define BENCH_EXPR_LEN 256
+#define BENCH_MAX_TOKENS 96
+
+// Room for an expression with a formatted amount in front, for remove_format
+#define BENCH_FORMATTED_LEN (BENCH_EXPR_LEN + 48)
+
+// Most benchmarks in one run
+#define BENCH_MAX 32
+
+// Change in ns/op above which a comparison reports a regression, percent
+#define BENCH_THRESHOLD 10.0
+
+// ALLOCATION COUNTING:
+//////////////////////////////////////////////////////////////////////////////
+
+// With glibc the allocator is replaced by thin wrappers that count calls,
+// which also catches allocations libc makes for the code under test (fopen
+// buffers, for instance). Elsewhere allocations are reported as unknown.
+#if defined(__GLIBC__)
+#define BENCH_COUNT_ALLOCS 1
+
+extern void* __libc_malloc(size_t size);
+extern void* __libc_calloc(size_t n, size_t size);
+extern void* __libc_realloc(void* ptr, size_t size);
+extern void __libc_free(void* ptr);
+
+static size_t alloc_count;
+
+void* malloc(size_t size) {
+    alloc_count++;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t n, size_t size) {
+    alloc_count++;
+    return __libc_calloc(n, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    alloc_count++;
+    return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) {
+    __libc_free(ptr);
+}
+#else
+#define BENCH_COUNT_ALLOCS 0
+static size_t alloc_count;
+#endif
+
+// CORPORA:
+//////////////////////////////////////////////////////////////////////////////
+
+// One generated expression, as text and as the argv tokens of the same sum.
+typedef struct {
+    char text[BENCH_EXPR_LEN];
+    size_t len;
+    char tokens[BENCH_EXPR_LEN];       // NUL-separated copies of the tokens
+    char* argv[BENCH_MAX_TOKENS];
+    int argc;
+    int overflow;                      // generated more than fits
+    double value;                      // result, for the formatting benchmark
+} BenchExpr;
+
+// One conversion request.
+typedef struct {
+    double value;
+    const char* from;
+    const char* to;
+} BenchConvert;
+
+// Everything the benchmarks read, built once before timing starts.
+typedef struct {
+    BenchExpr* exprs;
+    int expr_count;
+    char (*formatted)[BENCH_FORMATTED_LEN]; // numbers with ',' and '$', for remove_format
+    ConversionRules rules;
+    const char* rules_path;
+    char (*aliases)[MAX_NAME_LEN];     // every name of every unit
+    char (*names)[MAX_NAME_LEN];       // unit names to look up, some unknown
+    int name_count;
+    BenchConvert* converts;
+    int convert_count;
+} BenchData;
+
+static unsigned long long rng_state;
+
+// xorshift64*, so corpora depend only on the seed and not on the libc.
+static unsigned rng_next(void) {
+    rng_state ^= rng_state >> 12;
+    rng_state ^= rng_state << 25;
+    rng_state ^= rng_state >> 27;
+    return (unsigned)((rng_state * 2685821657736338717ULL) >> 32);
+}
+
+static unsigned rng_below(unsigned n) {
+    return rng_next() % n;
+}
+
+// Append one token to an expression being generated. The text gets the
+// token with a space before it unless it is a bracket or the first token,
+// as people usually type; the argv form gets it as its own argument, with
+// '^' spelled 'p' since the argv path takes only letter operators.
+static void add_token(BenchExpr* e, size_t* used, const char* tok) {
+    size_t n = strlen(tok);
+    if (e->argc == BENCH_MAX_TOKENS || e->len + n + 2 > BENCH_EXPR_LEN ||
+        *used + n + 1 > BENCH_EXPR_LEN) {
+        e->overflow = 1;
+        return;
+    }
+    int tight = e->len == 0 || tok[0] == ')' || tok[0] == ']' || tok[0] == '}' ||
+                e->text[e->len - 1] == '(' || e->text[e->len - 1] == '[' ||
+                e->text[e->len - 1] == '{' || e->text[e->len - 1] == '-';
+    if (!tight)
+        e->text[e->len++] = ' ';
+    memcpy(e->text + e->len, tok, n);
+    e->len += n;
+    e->text[e->len] = '\0';
+
+    e->argv[e->argc++] = e->tokens + *used;
+    memcpy(e->tokens + *used, tok, n + 1);
+    if (tok[0] == '^')
+        e->tokens[*used] = 'p';
+    else if (tok[0] == '*')
+        e->tokens[*used] = 'x';
+    *used += n + 1;
+}
+
+// Write a random operand: mostly small whole numbers and prices, sometimes
+// large amounts with thousands separators. Never zero, so divisions succeed.
+static void gen_number(char* buf, size_t size) {
+    unsigned kind = rng_below(10);
+    if (kind < 4)
+        snprintf(buf, size, "%u", 1 + rng_below(99));
+    else if (kind < 7)
+        snprintf(buf, size, "%u.%0*u", rng_below(1000), 1 + (int)(kind - 4),
+                 1 + rng_below(kind == 4 ? 9 : kind == 5 ? 99 : 999));
+    else if (kind < 9)
+        snprintf(buf, size, "%u,%03u.%02u", 1 + rng_below(999), rng_below(1000), rng_below(100));
+    else
+        snprintf(buf, size, "%u,%03u,%03u", 1 + rng_below(99), rng_below(1000), rng_below(1000));
+}
+
+// Generate a sum of terms, some of them bracketed, down to the given depth.
+static void gen_sum(BenchExpr* e, size_t* used, int depth) {
+    static const char* const sum_ops[] = { "+", "-" };
+    static const char* const product_ops[] = { "x", "*", "/", "x" };
+    static const char* const opens[] = { "(", "[", "{" };
+    static const char* const closes[] = { ")", "]", "}" };
+    int terms = 1 + (int)rng_below(depth > 0 ? 3 : 2);
+
+    for (int t = 0; t < terms; t++) {
+        if (t > 0)
+            add_token(e, used, sum_ops[rng_below(2)]);
+        int factors = 1 + (int)rng_below(3);
+        for (int f = 0; f < factors; f++) {
+            if (f > 0)
+                add_token(e, used, product_ops[rng_below(4)]);
+            if (depth > 0 && rng_below(4) == 0) {
+                int b = (int)rng_below(3);
+                add_token(e, used, opens[b]);
+                gen_sum(e, used, depth - 1);
+                add_token(e, used, closes[b]);
+                if (rng_below(8) == 0) {
+                    add_token(e, used, "^");
+                    add_token(e, used, "2");
+                }
+            }
+            else {
+                char num[32];
+                gen_number(num, sizeof(num));
+                add_token(e, used, num);
+            }
+        }
+    }
+}
+
+// Generate the expressions: a third short, like "12.5 x 3", the rest
+// longer sums with up to three levels of brackets.
+static int gen_exprs(BenchData* d, int count) {
+    d->exprs = calloc((size_t)count, sizeof(BenchExpr));
+    d->formatted = calloc((size_t)count, BENCH_FORMATTED_LEN);
+    if (!d->exprs || !d->formatted)
+        return 0;
+
+    for (int i = 0; i < count; i++) {
+        BenchExpr* e = &d->exprs[i];
+        int error = 1;
+        while (error) {
+            size_t used = 0;
+            e->len = 0;
+            e->argc = 0;
+            e->overflow = 0;
+            e->text[0] = '\0';
+            gen_sum(e, &used, i % 3 == 0 ? 0 : 1 + (int)rng_below(3));
+            if (e->overflow || e->len > BENCH_EXPR_LEN / 2)
+                continue;
+            e->value = evaluate_expr_string(e->text, &error);
+        }
+
+        // Amounts as they are pasted: dollar signs and thousands separators
+        char num[32];
+        gen_number(num, sizeof(num));
+        snprintf(d->formatted[i], BENCH_FORMATTED_LEN, "$%s + %s", num, e->text);
+    }
+    d->expr_count = count;
+    return 1;
+}
+
+// Collect every alias of every unit, then draw the names to look up from
+// them and from names no rule defines, and conversions from an alias to a
+// target its unit has a factor for.
+static int gen_units(BenchData* d, int count) {
+    static const char* const unknown[] = { "furlong", "league", "cubit", "fathom" };
+    const ConversionRules* r = &d->rules;
+    char (*aliases)[MAX_NAME_LEN] = d->aliases = calloc(MAX_UNITS * 8, MAX_NAME_LEN);
+    int alias_unit[MAX_UNITS * 8];
+    int alias_count = 0;
+
+    d->names = calloc((size_t)count, MAX_NAME_LEN);
+    d->converts = calloc((size_t)count, sizeof(BenchConvert));
+    if (!aliases || !d->names || !d->converts)
+        return 0;
+    for (int i = 0; i < r->unit_count; i++) {
+        char names[MAX_NAME_LEN];
+        if (r->units[i].to_count == 0)
+            continue;
+        strcpy(names, r->units[i].names);
+        for (char* tok = strtok(names, ","); tok && alias_count < MAX_UNITS * 8; tok = strtok(NULL, ",")) {
+            while (*tok == ' ')
+                tok++;
+            alias_unit[alias_count] = i;
+            strcpy(aliases[alias_count++], tok);
+        }
+    }
+    if (alias_count == 0 || r->converter_count == 0)
+        return 0;
+
+    for (int i = 0; i < count; i++) {
+        int k = (int)rng_below((unsigned)alias_count);
+        const ConversionUnit* u = &r->units[alias_unit[k]];
+        int targets = u->to_count < r->converter_count ? u->to_count : r->converter_count;
+
+        if (rng_below(10) == 0)
+            strcpy(d->names[i], unknown[rng_below(4)]);
+        else
+            strcpy(d->names[i], aliases[k]);
+        d->converts[i].value = (double)(1 + rng_below(100000)) / 100.0;
+        d->converts[i].from = aliases[k];
+        d->converts[i].to = r->converter_units[rng_below((unsigned)targets)];
+    }
+    d->name_count = count;
+    d->convert_count = count;
+    return 1;
+}
+
+// BENCHMARKS:
+//////////////////////////////////////////////////////////////////////////////
+
+// One benchmark: run performs ops operations, cycling through its corpus,
+// and returns a value that depends on them so the compiler cannot drop
+// them. available, if set, says whether its input could be prepared.
+typedef struct {
+    const char* name;
+    double (*run)(BenchData* d, long ops);
+    int (*available)(const BenchData* d);
+} BenchCase;
+
+// Result of one benchmark, as written to JSON.
+typedef struct {
+    char name[64];
+    long ops;
+    double ns_per_op;       // median over the samples
+    double ns_per_op_min;
+    double ops_per_sec;
+    double mb_per_sec;      // input bytes per second, 0 if not meaningful
+    double allocs_per_op;   // -1 if unknown
+} BenchResult;
+
+static long bench_bytes;    // input bytes read by the last run
+
+static double run_evaluate_expr_string(BenchData* d, long ops) {
+    double sum = 0;
+    for (long i = 0; i < ops; i++) {
+        BenchExpr* e = &d->exprs[i % d->expr_count];
+        int error;
+        sum += evaluate_expr_string(e->text, &error);
+        bench_bytes += (long)e->len;
+    }
+    return sum;
+}
+
+static double run_evaluate_argv(BenchData* d, long ops) {
+    double sum = 0;
+    for (long i = 0; i < ops; i++) {
+        BenchExpr* e = &d->exprs[i % d->expr_count];
+        int error;
+        sum += evaluate(e->argc, e->argv, &error);
+        bench_bytes += (long)e->len;
+    }
+    return sum;
+}
+
+static double run_format_output(BenchData* d, long ops) {
+    char out[CCAL_RESULT_MAX];
+    double sum = 0;
+    for (long i = 0; i < ops; i++) {
+        BenchExpr* e = &d->exprs[i % d->expr_count];
+        FormatOutput(e->text, e->value, out);
+        sum += out[0];
+        bench_bytes += (long)e->len;
+    }
+    return sum;
+}
+
+// remove_format works in place, so each operation also copies its input.
+static double run_remove_format(BenchData* d, long ops) {
+    char buf[BENCH_FORMATTED_LEN];
+    double sum = 0;
+    for (long i = 0; i < ops; i++) {
+        const char* s = d->formatted[i % d->expr_count];
+        size_t n = strlen(s);
+        memcpy(buf, s, n + 1);
+        remove_format(buf);
+        sum += buf[0];
+        bench_bytes += (long)n;
+    }
+    return sum;
+}
+
+static double run_load_conversion_rules(BenchData* d, long ops) {
+    ConversionRules rules;
+    double sum = 0;
+    for (long i = 0; i < ops; i++) {
+        sum += load_conversion_rules(d->rules_path, &rules);
+        sum += rules.unit_count;
+    }
+    return sum;
+}
+
+static int have_rules_file(const BenchData* d) {
+    return d->rules_path != NULL;
+}
+
+#ifdef USE_EMBEDDED_RULES
+static double run_load_embedded_conversion_rules(BenchData* d, long ops) {
+    ConversionRules rules;
+    double sum = 0;
+    (void)d;
+    for (long i = 0; i < ops; i++) {
+        sum += load_embedded_conversion_rules("length", &rules);
+        sum += rules.unit_count;
+    }
+    return sum;
+}
+#endif
+
+static double run_find_unit_by_name(BenchData* d, long ops) {
+    double sum = 0;
+    for (long i = 0; i < ops; i++)
+        sum += find_unit_by_name(&d->rules, d->names[i % d->name_count]);
+    return sum;
+}
+
+static double run_convert_unit(BenchData* d, long ops) {
+    double sum = 0;
+    for (long i = 0; i < ops; i++) {
+        const BenchConvert* c = &d->converts[i % d->convert_count];
+        sum += convert_unit(&d->rules, c->value, c->from, c->to);
+    }
+    return sum;
+}
+
+static const BenchCase bench_cases[] = {
+    { "evaluate_expr_string", run_evaluate_expr_string, NULL },
+    { "evaluate_argv", run_evaluate_argv, NULL },
+    { "FormatOutput", run_format_output, NULL },
+    { "remove_format", run_remove_format, NULL },
+    { "load_conversion_rules", run_load_conversion_rules, have_rules_file },
+#ifdef USE_EMBEDDED_RULES
+    { "load_embedded_conversion_rules", run_load_embedded_conversion_rules, NULL },
+#endif
+    { "find_unit_by_name", run_find_unit_by_name, NULL },
+    { "convert_unit", run_convert_unit, NULL },
+};
+
+// Monotonic clock in nanoseconds.
+static double bench_now(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart * 1e9 / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+#endif
+}
+
+static int compare_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static volatile double bench_sink;
+
+// Time one benchmark: double the operation count until one sample takes
+// min_ns, then take repeat samples of that many operations.
+static void run_case(const BenchCase* c, BenchData* d, double min_ns, int repeat, BenchResult* r) {
+    long ops = 1;
+    double t = 0;
+    for (;;) {
+        double t0 = bench_now();
+        bench_sink = c->run(d, ops);
+        t = bench_now() - t0;
+        if (t >= min_ns || ops > (1L << 40))
+            break;
+        ops *= t > 0 && min_ns / t < 16 ? 2 : 16;
+    }
+
+    double samples[64];
+    size_t allocs = 0;
+    long bytes = 0;
+    if (repeat > 64)
+        repeat = 64;
+    for (int s = 0; s < repeat; s++) {
+        size_t a0 = alloc_count;
+        bench_bytes = 0;
+        double t0 = bench_now();
+        bench_sink = c->run(d, ops);
+        samples[s] = (bench_now() - t0) / (double)ops;
+        allocs += alloc_count - a0;
+        bytes = bench_bytes;
+    }
+    qsort(samples, (size_t)repeat, sizeof(double), compare_double);
+
+    snprintf(r->name, sizeof(r->name), "%s", c->name);
+    r->ops = ops;
+    r->ns_per_op = samples[repeat / 2];
+    r->ns_per_op_min = samples[0];
+    r->ops_per_sec = 1e9 / r->ns_per_op;
+    r->mb_per_sec = (double)bytes / (double)ops * r->ops_per_sec / 1e6;
+    r->allocs_per_op = BENCH_COUNT_ALLOCS ? (double)allocs / ((double)ops * repeat) : -1;
+}
+
+// REPORTS:
+//////////////////////////////////////////////////////////////////////////////
+
+// Write results as JSON, one benchmark per line so baselines diff cleanly.
+static int write_json(const char* path, const BenchResult* res, int count,
+                      unsigned long long seed, int corpus, double min_ms, int repeat) {
+    FILE* fp = strcmp(path, "-") == 0 ? stdout : fopen(path, "w");
+    if (!fp)
+        return 0;
+    fprintf(fp, "{\n  \"seed\": %llu,\n  \"corpus\": %d,\n  \"min_time_ms\": %g,\n  \"repeat\": %d,\n",
+            seed, corpus, min_ms, repeat);
+    fprintf(fp, "  \"benchmarks\": [\n");
+    for (int i = 0; i < count; i++) {
+        const BenchResult* r = &res[i];
+        fprintf(fp, "    {\"name\": \"%s\", \"ops\": %ld, \"ns_per_op\": %.2f, \"ns_per_op_min\": %.2f, "
+                    "\"ops_per_sec\": %.0f, \"mb_per_sec\": %.2f, \"allocs_per_op\": ",
+                r->name, r->ops, r->ns_per_op, r->ns_per_op_min, r->ops_per_sec, r->mb_per_sec);
+        if (r->allocs_per_op < 0)
+            fprintf(fp, "null}");
+        else
+            fprintf(fp, "%.3f}", r->allocs_per_op);
+        fprintf(fp, "%s\n", i + 1 < count ? "," : "");
+    }
+    fprintf(fp, "  ]\n}\n");
+    if (fp != stdout)
+        fclose(fp);
+    return 1;
+}
+
+// Read the number after "key": within one benchmark object [obj, end).
+static int json_number(const char* obj, const char* end, const char* key, double* value) {
+    const char* p = strstr(obj, key);
+    if (!p || p >= end)
+        return 0;
+    p += strlen(key);
+    while (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n' || *p == ':')
+        p++;
+    char* num_end;
+    *value = strtod(p, &num_end);
+    return num_end != p && num_end <= end;
+}
+
+// Compare results against a baseline file written by --json. Prints the
+// change of each benchmark and returns the number that got slower by more
+// than threshold percent or allocate more, or -1 if the file cannot be read.
+static int compare_baseline(FILE* out, const char* path, const BenchResult* res, int count,
+                            double threshold) {
+    FILE* fp = fopen(path, "rb");
+    int regressions = 0;
+
+    if (!fp)
+        return -1;
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char* text = size >= 0 ? malloc((size_t)size + 1) : NULL;
+    if (!text || fread(text, 1, (size_t)size, fp) != (size_t)size) {
+        free(text);
+        fclose(fp);
+        return -1;
+    }
+    text[size] = '\0';
+    fclose(fp);
+
+    fprintf(out, "\n%-32s %12s %12s %9s\n", "compared to baseline", "baseline", "now", "change");
+    for (const char* p = strstr(text, "\"name\""); p; p = strstr(p, "\"name\"")) {
+        // Each benchmark is a flat object: its fields run to the next '}'
+        const char* end = strchr(p, '}');
+        if (!end)
+            break;
+        p = strchr(p + 6, '"');
+        double base_ns, base_allocs = -1;
+        if (!p || p >= end || !json_number(p, end, "\"ns_per_op\"", &base_ns)) {
+            p = end;
+            continue;
+        }
+        p++;
+        size_t n = strcspn(p, "\"");
+        json_number(p, end, "\"allocs_per_op\"", &base_allocs);
+
+        for (int i = 0; i < count; i++) {
+            if (strlen(res[i].name) != n || strncmp(res[i].name, p, n) != 0)
+                continue;
+            double change = (res[i].ns_per_op - base_ns) / base_ns * 100.0;
+            int slower = change > threshold;
+            int allocs = base_allocs >= 0 && res[i].allocs_per_op > base_allocs + 0.001;
+            fprintf(out, "%-32s %9.1f ns %9.1f ns %+8.1f%%%s%s\n", res[i].name, base_ns,
+                    res[i].ns_per_op, change, slower ? "  SLOWER" : "",
+                    allocs ? "  MORE ALLOCATIONS" : "");
+            regressions += slower || allocs;
+        }
+        p = end;
+    }
+    free(text);
+    return regressions;
+}
+
+static void usage(void) {
+    fprintf(stderr,
+            "Usage: ccal_bench [--filter NAME] [--time MS] [--repeat N] [--corpus N]\n"
+            "                  [--seed N] [--rules FILE] [--json FILE|-]\n"
+            "                  [--baseline FILE] [--threshold PERCENT]\n");
+}
+
+// MAIN FUNCTION:
+//////////////////////////////////////////////////////////////////////////////
+
+int main(int argc, char* argv[]) {
+    const char* filter = NULL;
+    const char* json_path = NULL;
+    const char* baseline = NULL;
+    double min_ms = 200;
+    double threshold = BENCH_THRESHOLD;
+    int repeat = 5;
+    int corpus = BENCH_CORPUS;
+    unsigned long long seed = 1;
+    BenchData d;
+
+    memset(&d, 0, sizeof(d));
+    d.rules_path = "rules/converter/length.json";
+    for (int i = 1; i < argc; i++) {
+        int more = i + 1 < argc;
+        if (strcmp(argv[i], "--filter") == 0 && more)
+            filter = argv[++i];
+        else if (strcmp(argv[i], "--time") == 0 && more)
+            min_ms = atof(argv[++i]);
+        else if (strcmp(argv[i], "--repeat") == 0 && more)
+            repeat = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--corpus") == 0 && more)
+            corpus = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--seed") == 0 && more)
+            seed = strtoull(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--rules") == 0 && more)
+            d.rules_path = argv[++i];
+        else if (strcmp(argv[i], "--json") == 0 && more)
+            json_path = argv[++i];
+        else if (strcmp(argv[i], "--baseline") == 0 && more)
+            baseline = argv[++i];
+        else if (strcmp(argv[i], "--threshold") == 0 && more)
+            threshold = atof(argv[++i]);
+        else {
+            usage();
+            return 2;
+        }
+    }
+    if (repeat < 1 || corpus < 1 || min_ms < 0) {
+        usage();
+        return 2;
+    }
+
+    // Rules come from the file when it can be read, else from the embedded copy
+    rng_state = seed * 0x9E3779B97F4A7C15ULL + 1;
+    if (!load_conversion_rules(d.rules_path, &d.rules)) {
+        d.rules_path = NULL;
+#ifdef USE_EMBEDDED_RULES
+        load_embedded_conversion_rules("length", &d.rules);
+#endif
+    }
+    if (!gen_exprs(&d, corpus) || !gen_units(&d, corpus)) {
+        fprintf(stderr, "Error: Cannot build the corpora (are the length rules available?)\n");
+        return 1;
+    }
+
+    // The table goes to stderr when the JSON goes to stdout
+    FILE* out = json_path && strcmp(json_path, "-") == 0 ? stderr : stdout;
+    BenchResult results[BENCH_MAX];
+    int count = 0;
+    fprintf(out, "%-32s %12s %14s %10s %12s\n", "benchmark", "ns/op", "ops/s", "MB/s", "allocs/op");
+    for (size_t i = 0; i < sizeof(bench_cases) / sizeof(bench_cases[0]); i++) {
+        const BenchCase* c = &bench_cases[i];
+        if (filter && !strstr(c->name, filter))
+            continue;
+        if (c->available && !c->available(&d))
+            continue;
+        BenchResult* r = &results[count++];
+        run_case(c, &d, min_ms * 1e6, repeat, r);
+        fprintf(out, "%-32s %12.1f %14.0f %10.1f ", r->name, r->ns_per_op, r->ops_per_sec, r->mb_per_sec);
+        if (r->allocs_per_op < 0)
+            fprintf(out, "%12s\n", "-");
+        else
+            fprintf(out, "%12.3f\n", r->allocs_per_op);
+        fflush(out);
+    }
+
+    if (json_path && !write_json(json_path, results, count, seed, corpus, min_ms, repeat)) {
+        fprintf(stderr, "Error: Cannot write %s\n", json_path);
+        return 1;
+    }
+    if (baseline) {
+        int regressions = compare_baseline(out, baseline, results, count, threshold);
+        if (regressions < 0) {
+            fprintf(stderr, "Error: Cannot read baseline %s\n", baseline);
+            return 1;
+        }
+        if (regressions > 0) {
+            fprintf(out, "%d benchmark(s) regressed by more than %g%%\n", regressions, threshold);
+            return 3;
+        }
+    }
+    return 0;
+}
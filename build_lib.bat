@@ -0,0 +1,21 @@
+@echo off
+REM Build script for libccal, the evaluator and unit converter as a library
+REM Produces libccal.a and ccal.dll exporting the ccal_* functions of ccal.h
+REM Extra arguments are passed to gcc, e.g. build_lib.bat -DUSE_EMBEDDED_RULES
+REM after running build_rules.bat
+
+set CFLAGS=-O2 -DCCAL_LIBRARY %*
+
+echo Compiling library objects...
+gcc %CFLAGS% -c ccal.c -o libccal_ccal.o || exit /b 1
+gcc %CFLAGS% -c modules\converter.c -o libccal_converter.o || exit /b 1
+gcc %CFLAGS% -c modules\incremental.c -o libccal_incremental.o || exit /b 1
+
+echo Creating libccal.a and ccal.dll...
+if exist libccal.a del libccal.a
+ar rcs libccal.a libccal_ccal.o libccal_converter.o libccal_incremental.o || exit /b 1
+gcc -shared libccal_ccal.o libccal_converter.o libccal_incremental.o -o ccal.dll -Wl,--out-implib,libccal.dll.a || exit /b 1
+del libccal_ccal.o libccal_converter.o libccal_incremental.o
+
+echo.
+echo Done! Include ccal.h and link with: gcc app.c -L. -lccal
@@ -0,0 +1,21 @@
+#!/bin/bash
+# Build script for libccal, the evaluator and unit converter as a library
+# Produces libccal.a and libccal.so exporting the ccal_* functions of ccal.h
+# Extra arguments are passed to gcc, e.g. ./build_lib.sh -DUSE_EMBEDDED_RULES
+# after running build_rules.sh
+
+CFLAGS="-O2 -fPIC -fvisibility=hidden -DCCAL_LIBRARY $*"
+
+echo "Compiling library objects..."
+gcc $CFLAGS -c ccal.c -o libccal_ccal.o || exit 1
+gcc $CFLAGS -c modules/converter.c -o libccal_converter.o || exit 1
+gcc $CFLAGS -c modules/incremental.c -o libccal_incremental.o || exit 1
+
+echo "Creating libccal.a and libccal.so..."
+rm -f libccal.a
+ar rcs libccal.a libccal_ccal.o libccal_converter.o libccal_incremental.o || exit 1
+gcc -shared libccal_ccal.o libccal_converter.o libccal_incremental.o -o libccal.so -lm || exit 1
+rm -f libccal_ccal.o libccal_converter.o libccal_incremental.o
+
+echo ""
+echo "Done! Include ccal.h and link with: gcc app.c -L. -lccal -lm"
@@ -32,4 +32,4 @@ echo Done! Generated headers:
 dir /b modules\*_rules.h modules\rules.h
 
 echo.
-echo Now compile with: gcc -DUSE_EMBEDDED_RULES ccal.c modules/converter.c -o ccal.exe
+echo Now compile with: gcc -DUSE_EMBEDDED_RULES ccal.c modules/converter.c modules/batch.c modules/serve.c modules/shm.c modules/repl.c modules/latency.c -o ccal.exe -pthread -lm
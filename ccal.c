@@ -8,12 +8,21 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <math.h>
+#include <limits.h>
+#include "ccal.h"
 #include "remove_format.h"
-#include "help.h"
+#include "trace.h"
 
-// Include converter module when not building GUI
-#ifndef BUILDING_GUI
+// Include the help text and the modules only for the command line tool;
+// the GUI and the libccal library (-DCCAL_LIBRARY) use just the evaluator
+#if !defined(BUILDING_GUI) && !defined(CCAL_LIBRARY)
+#include "help.h"
 #include "modules/converter.h"
+#include "modules/batch.h"
+#include "modules/serve.h"
+#include "modules/shm.h"
+#include "modules/repl.h"
 #endif
 
 // Note 2 The headers above mix standard C libraries for core facilities with project headers; recognizing which features stem from libc helps when porting this parser to constrained environments.
@@ -25,397 +34,2421 @@
 int hasDec = 0; // don't round if no decimal
 int maxDec = 0; // maximum number of meaningful decimals
 int offDec = 0; // if 1 turn off decimal formatting always
-// Note 3 These globals act as formatting state that persists across parsing passes, which mirrors the parser's single-threaded nature; in multi-threaded contexts you would wrap them in a struct instead.
+// Note 3 These globals only mirror the default context for callers of the legacy API (the GUI); the parser itself reads and writes the ccal_ctx it is handed, so separate contexts never share state.
+
+// Default context behind evaluate_expr_string, FormatOutput and friends.
+static ccal_ctx default_ctx = { "", "", 0, 0, 0, 0, NULL, 0, 0, CCAL_MAX_DEPTH, 0, NULL, NULL, 0, NULL, 0, NULL };
+// Note 4 Keeping the cursor inside the context preserves the classic recursive-descent pattern where each function consumes characters and leaves the remainder for its caller, while letting every thread own its own cursor.
+
+// Result cache of evaluate_expr_string, off until expr_cache_enable.
+static ccal_cache default_cache;
+
+#ifdef CCAL_TRACE
+// TRACE COUNTERS:
+//////////////////////////////////////////////////////////////////////////////
+
+_Atomic unsigned long long ccal_trace_counts[CCAL_TRACE_COUNTERS];
+_Atomic int ccal_trace_max_depth;
+
+static const char* const trace_names[CCAL_TRACE_COUNTERS] = {
+    "skip_spaces", "operand", "open", "shift", "reduce", "stack_grow",
+    "scan_number", "strtod", "term_eval", "expr_eval", "rule_line",
+    "find_unit", "alias", "find_target", "convert"
+};
+
+// Print every counter and the deepest nesting seen.
+void ccal_trace_print(FILE* fp) {
+    fprintf(fp, "%-12s %20s\n", "Trace", "count");
+    for (int i = 0; i < CCAL_TRACE_COUNTERS; i++)
+        fprintf(fp, "%-12s %20llu\n", trace_names[i],
+                atomic_load_explicit(&ccal_trace_counts[i], memory_order_relaxed));
+    fprintf(fp, "%-12s %20d\n", "max_depth",
+            atomic_load_explicit(&ccal_trace_max_depth, memory_order_relaxed));
+    fflush(fp);
+}
+// Note 103 Counting calls rather than timing them makes a pathological input explain itself: ten thousand brackets show up as ten thousand opens and a matching depth, a long run of padding as skip_spaces calls, and the counters cost nothing unless built in.
+#endif
+
+#ifdef CCAL_SDT
+// Semaphores of the evaluator's USDT probes (see trace.h).
+CCAL_PROBE_DEFINE(expr__start);
+CCAL_PROBE_DEFINE(expr__end);
+CCAL_PROBE_DEFINE(parse__error);
+#endif
+
+// Reset a context before its first evaluation.
+void ccal_ctx_init(ccal_ctx* ctx) {
+    ctx->expr_ptr = "";
+    ctx->expr_end = ctx->expr_ptr;
+    ctx->hasDec = 0;
+    ctx->maxDec = 0;
+    ctx->offDec = 0;
+    ctx->error = 0;
+    ctx->prog = NULL;
+    ctx->depth = 0;
+    ctx->columns = 0;
+    ctx->max_depth = CCAL_MAX_DEPTH;
+    ctx->nesting = 0;
+    ctx->values = NULL;
+    ctx->ops = NULL;
+    ctx->stack_cap = 0;
+    ctx->tokens = NULL;
+    ctx->token_cap = 0;
+    ctx->ans = NULL;
+}
+
+// Release the evaluation stacks and argv tokens a context grew. The context
+// may be initialized again afterwards.
+void ccal_ctx_free(ccal_ctx* ctx) {
+    free(ctx->values);
+    free(ctx->ops);
+    free(ctx->tokens);
+    ctx->values = NULL;
+    ctx->ops = NULL;
+    ctx->stack_cap = 0;
+    ctx->tokens = NULL;
+    ctx->token_cap = 0;
+}
+
+// Copy the legacy globals into the default context.
+static void load_default_ctx() {
+    default_ctx.hasDec = hasDec;
+    default_ctx.maxDec = maxDec;
+    default_ctx.offDec = offDec;
+}
+
+// Publish the default context back to the legacy globals.
+static void store_default_ctx() {
+    hasDec = default_ctx.hasDec;
+    maxDec = default_ctx.maxDec;
+    offDec = default_ctx.offDec;
+}
+// Note 84 Syncing on entry and exit of each legacy call keeps the GUI's habit of resetting hasDec/maxDec/offDec directly working, without the parser ever touching the globals.
+
+// Check for characters remove_format strips from pasted values.
+static int is_format_char(char c) {
+    return c == ',' || c == '$';
+}
 
-// Global pointer to current position in expression string
-static const char* expr_ptr;
-// Note 4 Maintaining a global pointer into the source string enables the classic recursive-descent pattern where each function consumes characters and leaves the remainder for its caller.
+// Check for a $N column placeholder at p, before end.
+static int is_column_ref(const ccal_ctx* ctx, const char* p, const char* end) {
+    return ctx->columns && *p == '$' && p + 1 < end && isdigit((unsigned char)p[1]);
+}
+
+// Check for the word "ans" at p, before end, when the context gives it a value.
+static int is_ans_ref(const ccal_ctx* ctx, const char* p, const char* end) {
+    return ctx->ans && end - p >= 3 && tolower((unsigned char)p[0]) == 'a' &&
+           tolower((unsigned char)p[1]) == 'n' && tolower((unsigned char)p[2]) == 's' &&
+           (end - p == 3 || !isalnum((unsigned char)p[3]));
+}
+
+// Current character of the expression, '\0' at the end of the span.
+// Formatting characters are stepped over as if remove_format had run.
+static char cur_char(ccal_ctx* ctx) {
+    while (ctx->expr_ptr < ctx->expr_end && is_format_char(*ctx->expr_ptr) &&
+           !is_column_ref(ctx, ctx->expr_ptr, ctx->expr_end))
+        ctx->expr_ptr++;
+    return ctx->expr_ptr < ctx->expr_end ? *ctx->expr_ptr : '\0';
+}
+// Note 89 Because the cursor is bounded by expr_end instead of a terminator, the parser can run directly over a line inside a larger read-only buffer such as a memory-mapped file.
 
 // Skip whitespace characters in the expression
-void skip_spaces() {
+void skip_spaces(ccal_ctx* ctx) {
+    CCAL_TRACE_HIT(CCAL_TRACE_SKIP_SPACES);
     // Note 75 Although minimal, this loop saves every other parser function from duplicating whitespace handling, highlighting the DRY principle in C.
-    while (*expr_ptr == ' ') expr_ptr++;
+    while (cur_char(ctx) == ' ') ctx->expr_ptr++;
 }
 // Note 5 Skipping whitespace must be called before each token-consuming routine so that the parser treats space as optional syntactic sugar rather than significant input.
 
+// Longest number text handed to strtod from the stack.
+#define NUMBER_BUF_LEN 64
+
+// End of the number text at p: the first character, formatting aside, that
+// strtod could not take as part of the number, or end. Decimal, hex and
+// inf/nan numbers can each be continued by different characters; reading
+// the number never looks further than the character returned.
+static const char* number_extent(const char* p, const char* end) {
+    int body = 0;   // characters past the whitespace and sign
+    int word = 0;   // inf or nan
+    int hex = 0;    // 0x prefix seen
+    char prev = 0;  // last character read, formatting aside
+    for (; p < end; p++) {
+        char c = *p;
+        if (is_format_char(c))
+            continue;
+        if (!body && (isspace((unsigned char)c) ||
+                      ((c == '+' || c == '-') && (!prev || isspace((unsigned char)prev))))) {
+            prev = c;
+            continue;
+        }
+        if (!body) {
+            if (isalpha((unsigned char)c))
+                word = 1;
+            else if (!isdigit((unsigned char)c) && c != '.')
+                break;
+        }
+        else if (word) {
+            if (!isalnum((unsigned char)c) && c != '_' && c != '(' && c != ')')
+                break;
+        }
+        else {
+            int after_exp = hex ? prev == 'p' || prev == 'P'
+                                : prev == 'e' || prev == 'E';
+            if ((c == 'x' || c == 'X') && !hex && body == 1 && prev == '0')
+                hex = 1;
+            else if (!((c == '+' || c == '-') && after_exp) && c != '.' &&
+                     !(hex ? isxdigit((unsigned char)c) || c == 'p' || c == 'P'
+                           : isdigit((unsigned char)c) || c == 'e' || c == 'E'))
+                break;
+        }
+        body++;
+        prev = c;
+    }
+    return p;
+}
+
+// Run strtod over a span that need not be terminated, stepping over
+// formatting characters. *stop receives the first unconsumed position.
+static double span_strtod(const char* p, const char* end, const char** stop) {
+    char local[NUMBER_BUF_LEN];
+    char* buf = local;
+
+    // copy only the number, not the rest of the span
+    const char* last = number_extent(p, end);
+    if (last - p >= NUMBER_BUF_LEN) {
+        // unusually long number, move to the heap
+        buf = malloc(last - p + 1);
+        if (!buf) {
+            buf = local;
+            last = p + NUMBER_BUF_LEN - 1;
+        }
+    }
+    size_t n = 0;
+    for (const char* q = p; q < last; q++) {
+        if (!is_format_char(*q))
+            buf[n++] = *q;
+    }
+    buf[n] = '\0';
+
+    char* e;
+    CCAL_TRACE_HIT(CCAL_TRACE_STRTOD);
+    double val = strtod(buf, &e);
+    size_t used = e - buf;
+    if (buf != local)
+        free(buf);
+
+    // map the consumed length back onto the span
+    const char* q = p;
+    while (used > 0) {
+        if (!is_format_char(*q))
+            used--;
+        q++;
+    }
+    *stop = q;
+    return val;
+}
+
+// Count meaningful decimals of the number text [start, end), stepping over
+// formatting characters. Returns -1 when the number has no decimal point.
+static int span_decimals(const char* start, const char* end) {
+    const char* dot = memchr(start, '.', end - start);
+    if (!dot)
+        return -1;
+
+    int count = 0;
+    const char* p = dot + 1;
+    while (p < end && (isdigit((unsigned char)*p) || is_format_char(*p))) {
+        if (!is_format_char(*p))
+            count++;
+        p++;
+    }
+
+    // trim trailing zeros beyond two places
+    const char* t = end - 1;
+    while (count > 2 && (*t == '0' || is_format_char(*t))) {
+        if (*t == '0')
+            count--;
+        t--;
+    }
+    return count;
+}
+
+// Powers of ten that a double holds exactly.
+static const double exact_pow10[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Largest integer a double holds exactly, 2^53.
+#define EXACT_MANTISSA 9007199254740992ULL
+
+// Step over formatting characters.
+static const char* skip_format(const char* p, const char* end) {
+    while (p < end && is_format_char(*p))
+        p++;
+    return p;
+}
+
+// Convert a number scan_number does not handle itself with strtod.
+static double scan_fallback(const char* p, const char* end, const char** stop,
+                            int* decimals) {
+    double val = span_strtod(p, end, stop);
+    *decimals = *stop == p ? -1 : span_decimals(p, *stop);
+    return val;
+}
+
+// Record mant x 10^exp10 in *num as a scaled integer when it fits.
+static void scan_exact(ccal_num* num, int neg, unsigned long long mant, int exp10) {
+    if (mant == 0)
+        exp10 = 0;
+    while (exp10 > 0 && mant <= LLONG_MAX / 10) {
+        mant *= 10;
+        exp10--;
+    }
+    while (exp10 < -CCAL_EXACT_SCALE && mant % 10 == 0) {
+        mant /= 10;
+        exp10++;
+    }
+    if (exp10 > 0 || exp10 < -CCAL_EXACT_SCALE || mant > LLONG_MAX)
+        return;
+    num->mant = neg ? -(long long)mant : (long long)mant;
+    num->scale = -exp10;
+    num->exact = 1;
+}
+
+// Scan a number from the span [p, end) in one pass, returning its value.
+// *stop receives the first unconsumed position, exactly where strtod would
+// stop, and *decimals the count span_decimals would give (-1 without a
+// decimal point). Decimal numbers with up to 19 significant digits and a
+// small exponent are converted exactly here; anything else, such as hex,
+// inf, nan or very long numbers, is left to strtod. When num is not NULL it
+// also receives the number as a scaled integer if one can hold it.
+static double scan_number(const char* p, const char* end, const char** stop,
+                          int* decimals, ccal_num* num) {
+    CCAL_TRACE_HIT(CCAL_TRACE_SCAN_NUMBER);
+    if (num)
+        num->exact = 0;
+
+    // leading whitespace and sign, as strtod accepts them
+    const char* q = p;
+    while (q < end && (is_format_char(*q) || isspace((unsigned char)*q)))
+        q++;
+    int neg = 0;
+    if (q < end && (*q == '+' || *q == '-')) {
+        neg = *q == '-';
+        q = skip_format(q + 1, end);
+    }
+
+    // inf, nan and hex numbers go to strtod
+    if (q < end && isalpha((unsigned char)*q))
+        return scan_fallback(p, end, stop, decimals);
+    if (q < end && *q == '0') {
+        const char* x = skip_format(q + 1, end);
+        if (x < end && (*x == 'x' || *x == 'X'))
+            return scan_fallback(p, end, stop, decimals);
+    }
+
+    unsigned long long mant = 0;
+    int digits = 0;     // significant digits in mant
+    int any = 0;        // saw at least one digit
+    int exp10 = 0;      // power of ten applied to mant
+    int frac = -1;      // digits after the point, -1 without a point
+    int zeros = 0;      // trailing '0' characters of the text so far
+    const char* last = NULL;
+
+    for (; q < end; q++) {
+        char c = *q;
+        if (is_format_char(c))
+            continue;
+        if (isdigit((unsigned char)c)) {
+            any = 1;
+            if (mant != 0 || c != '0') {
+                if (++digits > 19)
+                    return scan_fallback(p, end, stop, decimals);
+                mant = mant * 10 + (c - '0');
+            }
+            if (frac >= 0) {
+                frac++;
+                exp10--;
+            }
+            zeros = c == '0' ? zeros + 1 : 0;
+            last = q + 1;
+        }
+        else if (c == '.' && frac < 0) {
+            frac = 0;
+            zeros = 0;
+            if (any)
+                last = q + 1;
+        }
+        else {
+            break;
+        }
+    }
+    if (!any) {
+        *stop = p;
+        *decimals = -1;
+        return 0;
+    }
+
+    // exponent, only when digits follow the marker
+    if (q < end && (*q == 'e' || *q == 'E')) {
+        const char* r = skip_format(q + 1, end);
+        int exp_neg = 0;
+        if (r < end && (*r == '+' || *r == '-')) {
+            exp_neg = *r == '-';
+            r = skip_format(r + 1, end);
+        }
+        if (r < end && isdigit((unsigned char)*r)) {
+            int e = 0;
+            zeros = 0;
+            for (; r < end; r++) {
+                if (is_format_char(*r))
+                    continue;
+                if (!isdigit((unsigned char)*r))
+                    break;
+                if (e < 100000)
+                    e = e * 10 + (*r - '0');
+                zeros = *r == '0' ? zeros + 1 : 0;
+                last = r + 1;
+            }
+            exp10 += exp_neg ? -e : e;
+        }
+    }
+
+    // trim trailing zeros beyond two places, as span_decimals does
+    *decimals = frac;
+    while (*decimals > 2 && zeros > 0) {
+        (*decimals)--;
+        zeros--;
+    }
+    *stop = last;
+    if (num)
+        scan_exact(num, neg, mant, exp10);
+
+    if (mant == 0)
+        return neg ? -0.0 : 0.0;
+    if (mant <= EXACT_MANTISSA && exp10 >= -22 && exp10 <= 22) {
+        // both operands are exact, so one IEEE operation rounds correctly
+        double val = exp10 < 0 ? (double)mant / exact_pow10[-exp10]
+                               : (double)mant * exact_pow10[exp10];
+        return neg ? -val : val;
+    }
+    return span_strtod(p, end, stop);
+}
+// Note 94 Clinger's observation makes the fast path exact: a mantissa below 2^53 and a power of ten up to 1e22 are both exact doubles, so a single multiply or divide is correctly rounded and matches strtod bit for bit.
+
 // Forward declarations
-double parse_expr(int* error);
-double parse_term(int* error);
-double parse_factor(int* error);
-// Note 6 These forward declarations mirror the precedence hierarchy (expr > term > factor), reinforcing the idea that each level delegates to tighter-binding lower levels.
+ccal_num parse_expr(ccal_ctx* ctx);
+// Note 6 A single forward declaration is enough because the parser is one loop over an explicit stack rather than a family of mutually recursive functions.
 // Note 76 Having prototypes near the top also makes it easy to swap the implementation order later without breaking older C90 compilers that require declarations before use.
 
 // Global Functions.
 // Remove formatiing characters.
-void remove_format(char* s) {
+void ccal_remove_format(ccal_ctx* ctx, char* s) {
     char* d = s;
     // Note 60 Using separate read and write pointers lets us strip unwanted characters in-place without extra allocations—a common C idiom worth practicing.
     while (*s) {
         if (*s != ',' && *s != '$') *d++ = *s; // mind paste values - remove formatting
-        if (*s == '.' && hasDec == 0) hasDec = 1;
+        if (*s == '.' && ctx->hasDec == 0) ctx->hasDec = 1;
         s++;
     }
     *d = '\0';
 }
+
+// Remove formatting characters using the default context.
+void remove_format(char* s) {
+    load_default_ctx();
+    ccal_remove_format(&default_ctx, s);
+    store_default_ctx();
+}
 // Note 7 This sanitizer doubles as a fast path for detecting decimal input, demonstrating how preprocessing can cheaply seed state for later formatting decisions.
 // Note 77 Terminating the string manually is crucial because we may have skipped characters, so relying on the original null terminator would risk leaving stray data at the end.
 
 // Get the max number of decimals for formatting output.
-void max_decimals(int* num) {
-    skip_spaces();
+static void ctx_max_decimals(ccal_ctx* ctx, int* num) {
+    skip_spaces(ctx);
 
-    const char* start = expr_ptr;
-    char* end;
+    const char* start = ctx->expr_ptr;
+    const char* end;
     // Note 61 Capturing the start pointer allows us to detect whether strtod consumed any characters, which differentiates numbers from operators or stray symbols.
 
-    strtod(expr_ptr, &end); // parse the number to move expr_ptr.
-    // Note 50 Calling strtod without storing the result is intentional—we only care how many characters form the number to infer decimal precision.
+    if (start == ctx->expr_end) return; // end of expression
+    int count;
+    scan_number(start, ctx->expr_end, &end, &count, NULL); // parse the number to move expr_ptr.
+    // Note 50 Calling scan_number without storing the result is intentional—we only care how many characters form the number and how many decimals it has.
 
     if (end == start) return; // not a number
 
-    const char* dot = strchr(start, '.');
-    if (offDec == 1) {
-        hasDec = 0;
-        return; // no decimal formatting
+    if (ctx->offDec == 1) {
+        ctx->hasDec = 0;
+        return; // no decimal formatting
+    }
+    // Note 51 When offDec is clear we honor user formatting, treating decimal places as significant unless they are trailing zeros beyond cents precision.
+    if (count >= 0) {
+        ctx->hasDec = 1;
+        if (count > *num)
+            *num = count;
+    }
+    // Note 80 Advancing the scanning pointer ensures the next iteration evaluates the remainder of the expression, eventually terminating when we reach the end.
+
+    ctx->expr_ptr = end;
+}
+
+// Get the max number of decimals using the default context.
+void max_decimals(int* num) {
+    load_default_ctx();
+    ctx_max_decimals(&default_ctx, num);
+    store_default_ctx();
+}
+// Note 8 Tracking the maximum decimals while walking the expression lets the formatter respect user intent—notice how trailing zeros are trimmed only beyond two places to balance fidelity and readability.
+
+// Find the decimal precision of the numbers in the expression span
+// [expr, expr + len) by scanning its text.
+static void scan_decimals(const char* expr, size_t len, int* has_dec, int* max_dec) {
+    const char* p = expr;
+    const char* expr_end = expr + len;
+    *has_dec = 0;
+    *max_dec = 0;
+
+    while (p < expr_end) {
+        while (p < expr_end && (*p == ' ' || *p == '\t'))
+            ++p;
+        // Note 10 Skipping spaces on every iteration keeps the scanner tolerant of user formatting, mirroring the approach used by the parser itself.
+        // Note 79 Only space and tab are handled because command-line parsing from argv strips other whitespace characters, simplifying the normalization logic.
+
+        // only these characters can start a number strtod accepts
+        if (p == expr_end)
+            break;
+        if (!isdigit((unsigned char)*p) && !strchr(".+-iInN", *p)) {
+            ++p;
+            continue;
+        }
+
+        const char* end;
+        int count;
+        scan_number(p, expr_end, &end, &count, NULL);
+        if (end == p) {
+            ++p;
+            continue;
+        }
+        // Note 11 scan_number reports the decimals along with the end of the number, so the scanner never walks the same digits twice.
+        // Note 78 If strtod fails, we advance by one character to avoid getting stuck—this mirrors primitive lexers that recover by skipping unknown symbols.
+
+        if (count >= 0) {
+            *has_dec = 1;
+            // Note 12 Counting digits after the decimal helps decide whether to keep precision or clamp to two decimals for currency-style outputs.
+            // Note 62 scan_number also trims trailing zeros beyond two places, so numbers like 3.1400 are not reported with four decimals when only two carry meaning, a nuance finance learners often appreciate.
+            // Note 13 Trimming trailing zeros illustrates a common formatting compromise: align with human expectations without losing core numeric intent.
+
+            if (count > *max_dec)
+                *max_dec = count;
+        }
+
+        p = end;
+    }
+}
+// Note 82 This scanner only serves callers that hand over bare text, such as the GUI's FormatOutput; every evaluator fills a ccal_result during its single parse instead.
+
+#ifdef __SIZEOF_INT128__
+typedef unsigned __int128 fmt_u128;
+
+// Number of significant bits in v.
+static int fmt_bits(fmt_u128 v) {
+    unsigned long long hi = (unsigned long long)(v >> 64);
+    if (hi)
+        return 128 - __builtin_clzll(hi);
+    return v ? 64 - __builtin_clzll((unsigned long long)v) : 0;
+}
+
+// Round |x| * 10^n to the nearest integer, ties to even, exactly. x is
+// split into its 53-bit mantissa and binary exponent so the whole product
+// is a fraction of two 128-bit integers. Returns 0 when it does not fit.
+static int fmt_scaled(double x, int n, fmt_u128* out) {
+    int e;
+    double f = frexp(fabs(x), &e);
+    fmt_u128 num = (unsigned long long)ldexp(f, 53);
+    fmt_u128 den = 1;
+    fmt_u128 p5 = 1;
+    int k = n < 0 ? -n : n;
+    int shift = e - 53 + n;
+
+    if (k > 54)
+        return 0;
+    while (k-- > 0)
+        p5 *= 5;
+    if (n >= 0) {
+        if (fmt_bits(num) + fmt_bits(p5) > 127)
+            return 0;
+        num *= p5;
+    }
+    else {
+        den = p5;
+    }
+
+    if (shift >= 0) {
+        if (fmt_bits(num) + shift > 127)
+            return 0;
+        num <<= shift;
+    }
+    else {
+        // Anything below one half rounds to zero however large den gets
+        if (fmt_bits(num) + 2 <= fmt_bits(den) - shift) {
+            *out = 0;
+            return 1;
+        }
+        if (fmt_bits(den) - shift > 126)
+            return 0;
+        den <<= -shift;
+    }
+
+    fmt_u128 q = num / den;
+    fmt_u128 twice = (num - q * den) << 1;
+    if (twice > den || (twice == den && (q & 1)))
+        q++;
+    *out = q;
+    return 1;
+}
+
+// Write the decimal digits of v, zero padded to at least width digits.
+static int fmt_digits(fmt_u128 v, int width, char* buf) {
+    char tmp[64];
+    int len = 0;
+    while (v >= 10000000000000000000ULL) {
+        unsigned long long low = (unsigned long long)(v % 10000000000000000000ULL);
+        v /= 10000000000000000000ULL;
+        for (int i = 0; i < 19; i++, low /= 10)
+            tmp[len++] = (char)('0' + low % 10);
+    }
+    unsigned long long low = (unsigned long long)v;
+    do {
+        tmp[len++] = (char)('0' + low % 10);
+        low /= 10;
+    } while (low);
+    while (len < width)
+        tmp[len++] = '0';
+    for (int i = 0; i < len; i++)
+        buf[i] = tmp[len - 1 - i];
+    return len;
+}
+
+// Write q / 10^decimals with decimals places, dropping an all-zero
+// fraction. Returns the length written.
+static int fmt_fixed_digits(int neg, fmt_u128 q, int decimals, char* buf) {
+    char digits[64];
+    int len = 0;
+    if (neg)
+        buf[len++] = '-';
+    int count = fmt_digits(q, decimals + 1, digits);
+    int whole = count - decimals;
+    memcpy(buf + len, digits, whole);
+    len += whole;
+
+    int zero = 1;
+    for (int i = whole; i < count; i++) {
+        if (digits[i] != '0') {
+            zero = 0;
+            break;
+        }
+    }
+    if (!zero) {
+        buf[len++] = '.';
+        memcpy(buf + len, digits + whole, decimals);
+        len += decimals;
+    }
+    buf[len] = '\0';
+    return len;
+}
+
+// Write the 16 significant digits in q, scaled by 10^exp10, the way "%.16g"
+// lays them out. Returns the length written.
+static int fmt_general_digits(int neg, fmt_u128 q, int exp10, char* buf) {
+    char digits[64];
+    int len = 0;
+    if (neg)
+        buf[len++] = '-';
+    fmt_digits(q, 16, digits);
+    int sig = 16;
+    while (digits[sig - 1] == '0')
+        sig--;
+
+    if (exp10 < -4 || exp10 >= 16) {
+        buf[len++] = digits[0];
+        if (sig > 1) {
+            buf[len++] = '.';
+            memcpy(buf + len, digits + 1, sig - 1);
+            len += sig - 1;
+        }
+        buf[len++] = 'e';
+        buf[len++] = exp10 < 0 ? '-' : '+';
+        int mag = exp10 < 0 ? -exp10 : exp10;
+        if (mag >= 100)
+            buf[len++] = (char)('0' + mag / 100);
+        buf[len++] = (char)('0' + mag / 10 % 10);
+        buf[len++] = (char)('0' + mag % 10);
+    }
+    else if (exp10 < 0) {
+        buf[len++] = '0';
+        buf[len++] = '.';
+        for (int i = 1; i < -exp10; i++)
+            buf[len++] = '0';
+        memcpy(buf + len, digits, sig);
+        len += sig;
+    }
+    else {
+        memcpy(buf + len, digits, exp10 + 1);
+        len += exp10 + 1;
+        if (sig > exp10 + 1) {
+            buf[len++] = '.';
+            memcpy(buf + len, digits + exp10 + 1, sig - exp10 - 1);
+            len += sig - exp10 - 1;
+        }
+    }
+    buf[len] = '\0';
+    return len;
+}
+
+// Same text as "%.*f" followed by dropping an all-zero fraction.
+// Returns the length written, or -1 when the value needs snprintf.
+static int fmt_fixed(double x, int decimals, char* buf) {
+    fmt_u128 q;
+    if (!isfinite(x) || !fmt_scaled(x, decimals, &q))
+        return -1;
+    return fmt_fixed_digits(signbit(x) != 0, q, decimals, buf);
+}
+
+// Same text as "%.16g". Returns the length written, or -1 when the value
+// needs snprintf.
+static int fmt_general(double x, char* buf) {
+    fmt_u128 q;
+    if (!isfinite(x))
+        return -1;
+    if (x == 0) {
+        int len = 0;
+        if (signbit(x))
+            buf[len++] = '-';
+        buf[len++] = '0';
+        buf[len] = '\0';
+        return len;
+    }
+
+    // Find the exponent that leaves exactly 16 significant digits
+    int exp10 = (int)floor(log10(fabs(x)));
+    for (;;) {
+        if (!fmt_scaled(x, 15 - exp10, &q))
+            return -1;
+        if (q >= 10000000000000000ULL)
+            exp10++;
+        else if (q < 1000000000000000ULL)
+            exp10--;
+        else
+            break;
+    }
+    // 10^15 may be a value just under the next power of ten rounded up
+    if (q == 1000000000000000ULL) {
+        fmt_u128 below;
+        if (!fmt_scaled(x, 16 - exp10, &below))
+            return -1;
+        if (below < 10000000000000000ULL) {
+            q = below;
+            exp10--;
+        }
+    }
+    return fmt_general_digits(signbit(x) != 0, q, exp10, buf);
+}
+
+// Divide v by 10^k, rounding ties to even.
+static fmt_u128 fmt_round_down(fmt_u128 v, int k) {
+    if (v >> 64 == 0 && k <= 19) {
+        unsigned long long p = 1;
+        while (k-- > 0)
+            p *= 10;
+        unsigned long long q = (unsigned long long)v / p;
+        unsigned long long rest = (unsigned long long)v - q * p;
+        if (rest > p - rest || (rest == p - rest && (q & 1)))
+            q++;
+        return q;
+    }
+    fmt_u128 p = 1;
+    while (k-- > 0)
+        p *= 10;
+    fmt_u128 q = v / p;
+    fmt_u128 twice = (v - q * p) * 2;
+    if (twice > p || (twice == p && (q & 1)))
+        q++;
+    return q;
+}
+
+// Write an exact result mant / 10^scale with the given decimals, or in the
+// "%.16g" layout when decimals is negative. Returns the length written, or
+// -1 when the digits do not fit.
+static int fmt_exact(const ccal_result* res, int decimals, char* buf) {
+    int neg = res->mant < 0 || (res->mant == 0 && signbit(res->value));
+    fmt_u128 q = res->mant < 0 ? -(fmt_u128)res->mant : (fmt_u128)res->mant;
+
+    if (decimals >= 0) {
+        if (decimals - res->scale > 19)
+            return -1;
+        if (decimals >= res->scale)
+            for (int i = res->scale; i < decimals; i++)
+                q *= 10;
+        else
+            q = fmt_round_down(q, res->scale - decimals);
+        return fmt_fixed_digits(neg, q, decimals, buf);
+    }
+
+    if (q == 0)
+        return fmt_general(res->value, buf);
+    char digits[64];
+    int count = fmt_digits(q, 1, digits);
+    int exp10 = count - 1 - res->scale;
+    if (count > 16) {
+        q = fmt_round_down(q, count - 16);
+        if (q == 10000000000000000ULL) {
+            q /= 10;
+            exp10++;
+        }
+    }
+    for (; count < 16; count++)
+        q *= 10;
+    return fmt_general_digits(neg, q, exp10, buf);
+}
+#else
+static int fmt_fixed(double x, int decimals, char* buf) {
+    (void)x; (void)decimals; (void)buf;
+    return -1;
+}
+
+static int fmt_general(double x, char* buf) {
+    (void)x; (void)buf;
+    return -1;
+}
+
+static int fmt_exact(const ccal_result* res, int decimals, char* buf) {
+    (void)res; (void)decimals; (void)buf;
+    return -1;
+}
+#endif
+// Note 95 Both writers produce exactly the digits printf would, but they work on the double's exact binary value with integer arithmetic, so there is no locale lookup, no format string to parse and no second pass over the text to spot an all-zero fraction.
+
+// Insert ',' between every three digits of the leading integer part, the
+// way FormatSegment in the GUI groups what the user types.
+static int fmt_group(char* buf, int len) {
+    int start = buf[0] == '-' ? 1 : 0;
+    int end = start;
+    while (end < len && isdigit((unsigned char)buf[end]))
+        end++;
+    int commas = (end - start - 1) / 3;
+    if (commas <= 0)
+        return len;
+
+    memmove(buf + end + commas, buf + end, len - end + 1);
+    int dst = end + commas - 1;
+    for (int src = end - 1, run = 0; src >= start; src--) {
+        buf[dst--] = buf[src];
+        if (++run % 3 == 0 && src > start)
+            buf[dst--] = ',';
+    }
+    return len + commas;
+}
+
+// Format an evaluation result with the precision recorded while parsing it
+// and return the length written. fin_str needs 64 bytes, or
+// CCAL_RESULT_MAX with CCAL_FORMAT_GROUP.
+size_t ccal_write_result(const ccal_result* res, int flags, char* fin_str) {
+    double result = res->value;
+    int len;
+    if (res->offDec == 1 || !res->hasDec) {
+        len = res->exact ? fmt_exact(res, -1, fin_str) : -1;
+        if (len < 0)
+            len = fmt_general(result, fin_str);
+        if (len < 0) {
+            snprintf(fin_str, 64, "%.16g", result);
+            len = (int)strlen(fin_str);
+        }
+    }
+    else {
+        int decimals = res->maxDec <= 2 ? 2 : res->maxDec;
+        len = res->exact ? fmt_exact(res, decimals, fin_str) : -1;
+        if (len < 0)
+            len = fmt_fixed(result, decimals, fin_str);
+        if (len < 0) {
+            // Format with appropriate precision first
+            snprintf(fin_str, 64, "%.*f", decimals, result);
+            // Note 63 Leveraging snprintf with a precision field (%.*f) is a powerful technique when formatting rules depend on runtime analysis rather than fixed templates.
+
+            // If all decimal digits are zeros, format as integer
+            char* dot_pos = strchr(fin_str, '.');
+            if (dot_pos != NULL) {
+                char* p = dot_pos + 1;
+                while (*p == '0')
+                    p++;
+                if (*p == '\0')
+                    *dot_pos = '\0';
+            }
+            len = (int)strlen(fin_str);
+        }
+    }
+
+    if (flags & CCAL_FORMAT_GROUP)
+        len = fmt_group(fin_str, len);
+    return (size_t)len;
+}
+// Note 14 The conditional at the end keeps integer results compact while still honoring high-precision operands, showcasing a user-centric formatting strategy.
+
+// Format an evaluation result with the precision recorded while parsing it.
+void ccal_format_result(const ccal_result* res, char* fin_str) {
+    ccal_write_result(res, 0, fin_str);
+}
+
+// Format the final output based on decimal precision found in the expression
+// span [expr, expr + len). Used when only the text of an expression is known;
+// evaluations carry their precision in a ccal_result instead.
+void ccal_format_output_span(ccal_ctx* ctx, const char* expr, size_t len,
+                             double result, char* fin_str) {
+    if (ctx->offDec == 1) {
+        ctx->hasDec = 0;
+        ctx->maxDec = 0;
+        // Note 9 The offDec flag short-circuits formatting for operations like multiplication where scientific precision matters more than user-friendly grouping.
+    }
+    else {
+        scan_decimals(expr, len, &ctx->hasDec, &ctx->maxDec);
+    }
+
+    ccal_result res = { result, ctx->hasDec, ctx->maxDec, ctx->offDec, 0, 0, 0 };
+    ccal_format_result(&res, fin_str);
+}
+
+// Format the final output based on decimal precision found in the expression.
+void ccal_format_output(ccal_ctx* ctx, const char* expr, double result, char* fin_str) {
+    ccal_format_output_span(ctx, expr, strlen(expr), result, fin_str);
+}
+
+// Format the final output using the default context.
+void FormatOutput(const char* expr, double result, char* fin_str) {
+    load_default_ctx();
+    ccal_format_output(&default_ctx, expr, result, fin_str);
+    store_default_ctx();
+}
+
+// Largest exponent handled by squaring; every integer up to it is exact.
+#define POWER_INT_LIMIT 9007199254740992.0  // 2^53
+
+// Calculate power of call for a whole-number exponent by repeated squaring.
+double power_of(double base, long long expo) {
+    double result = 1;
+    while (expo > 0) {
+        if (expo & 1)
+            result *= base;
+        base *= base;
+        expo >>= 1;
+    }
+    return result;
+}
+// Note 15 Squaring halves the exponent each step, so 2^100000000 takes 27 multiplications instead of a hundred million; small exponents still multiply exactly as a hand-written loop would, keeping regression output stable.
+
+// Apply the exponent operator shared by every evaluator. Zero raised to a
+// negative power and a negative base raised to a fractional power have no
+// real result and set *error.
+static double apply_power(double left, double right, int* error) {
+    if (right == 0)
+        return 1;  // every base, 0 included, to the power 0
+    if (left == 0 && right < 0) {
+        *error = 1;  // same as dividing by zero
+        return 0;
+    }
+
+    if (right == floor(right) && fabs(right) <= POWER_INT_LIMIT) {
+        double result = power_of(left, (long long)fabs(right));
+        return right < 0 ? 1 / result : result;
+    }
+    if (left < 0 && right == right && right != floor(right)) {
+        *error = 1;  // e.g. the square root of a negative number
+        return 0;
+    }
+    return pow(left, right);
+}
+
+// A number that only has a double value.
+static ccal_num num_of(double value) {
+    ccal_num n = { value, 0, 0, 0 };
+    return n;
+}
+
+#ifdef __SIZEOF_INT128__
+static const long long exact_pow10_ll[] = {
+    1LL, 10LL, 100LL, 1000LL, 10000LL, 100000LL, 1000000LL, 10000000LL,
+    100000000LL, 1000000000LL, 10000000000LL, 100000000000LL,
+    1000000000000LL, 10000000000000LL, 100000000000000LL,
+    1000000000000000LL, 10000000000000000LL, 100000000000000000LL,
+    1000000000000000000LL
+};
+
+// Keep v / 10^scale as the exact value of *n if a scaled int64 holds it,
+// shedding trailing zeros to make room; otherwise n stays a plain double.
+static void exact_store(ccal_num* n, __int128 v, int scale) {
+    while ((scale > CCAL_EXACT_SCALE || v > LLONG_MAX || v < -LLONG_MAX) &&
+           scale > 0 && v % 10 == 0) {
+        v /= 10;
+        scale--;
+    }
+    if (scale > CCAL_EXACT_SCALE || v > LLONG_MAX || v < -LLONG_MAX) {
+        n->exact = 0;
+        return;
+    }
+    n->mant = (long long)v;
+    n->scale = scale;
+}
+
+// Exact a + b, or a - b when sub is set, into *a.
+static void exact_add(ccal_num* a, const ccal_num* b, int sub) {
+    if (!a->exact || !b->exact) {
+        a->exact = 0;
+        return;
+    }
+    __int128 x = a->mant;
+    __int128 y = b->mant;
+    int scale = a->scale;
+    if (a->scale < b->scale) {
+        x *= exact_pow10_ll[b->scale - a->scale];
+        scale = b->scale;
+    }
+    else {
+        y *= exact_pow10_ll[a->scale - b->scale];
+    }
+    exact_store(a, sub ? x - y : x + y, scale);
+}
+
+// Exact a * b into *a.
+static void exact_mul(ccal_num* a, const ccal_num* b) {
+    if (!a->exact || !b->exact) {
+        a->exact = 0;
+        return;
+    }
+    exact_store(a, (__int128)a->mant * b->mant, a->scale + b->scale);
+}
+
+// Largest quotient exact_div can still multiply by 10^CCAL_EXACT_SCALE.
+#define EXACT_RESCALE_LIMIT ((__int128)1 << 66)
+
+// Exact a / b into *a when the quotient terminates within CCAL_EXACT_SCALE
+// places, as 10 / 4 does and 1 / 3 does not. b must not be zero.
+static void exact_div(ccal_num* a, const ccal_num* b) {
+    if (!a->exact || !b->exact) {
+        a->exact = 0;
+        return;
+    }
+    // a / b terminates only if the part of b left after removing its
+    // factors of 2 and 5 divides a
+    long long num = a->mant;
+    unsigned long long den = b->mant < 0 ? 0 - (unsigned long long)b->mant
+                                         : (unsigned long long)b->mant;
+    int twos = 0;
+    int fives = 0;
+    while (!(den & 1)) {
+        den >>= 1;
+        twos++;
+    }
+    while (den % 5 == 0) {
+        den /= 5;
+        fives++;
+    }
+    if (num % (long long)den != 0) {
+        a->exact = 0;
+        return;
+    }
+
+    // num / (den 2^twos 5^fives) = (num / den) 2^(k - twos) 5^(k - fives) / 10^k
+    int k = twos > fives ? twos : fives;
+    int scale = a->scale - b->scale + k;
+    if (k > CCAL_EXACT_SCALE + 1 || scale > 2 * CCAL_EXACT_SCALE) {
+        a->exact = 0;
+        return;
+    }
+    __int128 q = num / (long long)den;
+    for (int i = twos; i < k; i++)
+        q *= 2;
+    for (int i = fives; i < k; i++)
+        q *= 5;
+    if (b->mant < 0)
+        q = -q;
+    if (scale < 0) {
+        if (q > EXACT_RESCALE_LIMIT || q < -EXACT_RESCALE_LIMIT || -scale > CCAL_EXACT_SCALE) {
+            a->exact = 0;
+            return;
+        }
+        q *= exact_pow10_ll[-scale];
+        scale = 0;
+    }
+    exact_store(a, q, scale);
+}
+
+// Exact -a into *a.
+static void exact_neg(ccal_num* a) {
+    a->mant = -a->mant;  // exact_store keeps mant above LLONG_MIN
+}
+
+// Exact a ^ b into *a for a whole exponent b, by squaring. b must not
+// raise zero to a negative power.
+static void exact_pow(ccal_num* a, const ccal_num* b) {
+    if (!a->exact || !b->exact || b->mant % exact_pow10_ll[b->scale] != 0) {
+        a->exact = 0;
+        return;
+    }
+    long long expo = b->mant / exact_pow10_ll[b->scale];
+    ccal_num base = *a;
+    ccal_num result = num_of(1);
+    result.mant = 1;
+    result.exact = 1;
+    for (long long e = expo < 0 ? -expo : expo; e > 0 && result.exact; e >>= 1) {
+        if (e & 1)
+            exact_mul(&result, &base);
+        if (e > 1)
+            exact_mul(&base, &base);
+        if (!base.exact)
+            result.exact = 0;
+    }
+    if (result.exact && expo < 0) {
+        ccal_num one = num_of(1);
+        one.mant = 1;
+        one.exact = 1;
+        exact_div(&one, &result);
+        result = one;
+    }
+    a->mant = result.mant;
+    a->scale = result.scale;
+    a->exact = result.exact;
+}
+#else
+static void exact_add(ccal_num* a, const ccal_num* b, int sub) {
+    (void)b; (void)sub;
+    a->exact = 0;
+}
+
+static void exact_mul(ccal_num* a, const ccal_num* b) {
+    (void)b;
+    a->exact = 0;
+}
+
+static void exact_div(ccal_num* a, const ccal_num* b) {
+    (void)b;
+    a->exact = 0;
+}
+
+static void exact_neg(ccal_num* a) {
+    a->exact = 0;
+}
+
+static void exact_pow(ccal_num* a, const ccal_num* b) {
+    (void)b;
+    a->exact = 0;
+}
+#endif
+// Note 96 Money is written in decimals that binary doubles cannot hold, so 0.1 x 3 drifts to 0.30000000000000004; keeping the same numbers as integers counted in tenths, hundredths and so on makes + - x and terminating / exact, and the double only takes over once a result no longer fits.
+
+// Check whether a divisor or a negative power's base is zero, trusting the
+// exact value over a double that rounding left slightly off zero.
+static int num_is_zero(const ccal_num* n) {
+    return n->exact ? n->mant == 0 : n->value == 0;
+}
+
+// Settle the double of an exact result to the nearest double of its exact
+// value, so 0.1 + 0.2 returns the same double as typing 0.3.
+static void num_settle(ccal_num* n) {
+    if (!n->exact)
+        return;
+    if (n->mant == 0) {
+        if (n->value != 0)
+            n->value = 0;  // keep the sign of a typed -0
+    }
+    else if (n->mant <= (long long)EXACT_MANTISSA && n->mant >= -(long long)EXACT_MANTISSA &&
+             n->scale <= 22) {
+        n->value = (double)n->mant / exact_pow10[n->scale];
+    }
+}
+
+/*****************************************************************************
+*  COMPILED EXPRESSIONS:                                                     *
+*****************************************************************************/
+
+// COMPILED EXPRESSIONS - EMITTER:
+//////////////////////////////////////////////////////////////////////////////
+
+// Append one instruction to the program being compiled.
+static void emit_insn(ccal_ctx* ctx, int op, int arg) {
+    ccal_program* prog = ctx->prog;
+    if (prog->code_len == prog->code_cap) {
+        int cap = prog->code_cap ? prog->code_cap * 2 : 16;
+        ccal_insn* code = realloc(prog->code, cap * sizeof(ccal_insn));
+        if (!code) {
+            ctx->error = 1;
+            return;
+        }
+        prog->code = code;
+        prog->code_cap = cap;
+    }
+    prog->code[prog->code_len].op = op;
+    prog->code[prog->code_len].arg = arg;
+    prog->code_len++;
+
+    // track value stack depth so ccal_exec can size its stack up front
+    if (op == CCAL_OP_CONST || op == CCAL_OP_COL) {
+        if (++ctx->depth > prog->max_stack)
+            prog->max_stack = ctx->depth;
+    }
+    else if (op != CCAL_OP_NEG) {
+        ctx->depth--;
+    }
+}
+
+// Append a constant to the pool and emit the instruction pushing it.
+static void emit_const(ccal_ctx* ctx, double val) {
+    ccal_program* prog = ctx->prog;
+    if (prog->const_count == prog->const_cap) {
+        int cap = prog->const_cap ? prog->const_cap * 2 : 16;
+        double* consts = realloc(prog->consts, cap * sizeof(double));
+        if (!consts) {
+            ctx->error = 1;
+            return;
+        }
+        prog->consts = consts;
+        prog->const_cap = cap;
+    }
+    prog->consts[prog->const_count] = val;
+    emit_insn(ctx, CCAL_OP_CONST, prog->const_count++);
+}
+// Note 85 Emitting postfix order falls straight out of recursive descent: each operator is appended after both of its operands were parsed, so the program runs on a plain value stack.
+
+// COMPILED EXPRESSIONS - OPTIMIZER:
+//////////////////////////////////////////////////////////////////////////////
+
+// Node of the expression graph rebuilt from a postfix program.
+typedef struct {
+    int op;      // CCAL_OP_* code
+    int a;       // first operand node, -1 for leaves
+    int b;       // second operand node, -1 for leaves and CCAL_OP_NEG
+    int arg;     // column for CCAL_OP_COL
+    double val;  // value for CCAL_OP_CONST
+    int uses;    // references from other nodes
+    int slot;    // temporary holding the computed value, -1 until stored
+} opt_node;
+
+// Check whether an operation pops two values.
+static int is_binary_op(int op) {
+    return op == CCAL_OP_ADD || op == CCAL_OP_SUB || op == CCAL_OP_MUL ||
+           op == CCAL_OP_DIV || op == CCAL_OP_POW;
+}
+
+// Hash a node by its operation and operands.
+static unsigned long opt_hash(const opt_node* n) {
+    unsigned long long bits = 0;
+    memcpy(&bits, &n->val, sizeof(bits));
+    unsigned long long h = (unsigned long long)n->op * 0x9E3779B97F4A7C15ULL;
+    h ^= (unsigned long long)(n->a + 1) * 0xC2B2AE3D27D4EB4FULL;
+    h ^= (unsigned long long)(n->b + 1) * 0x165667B19E3779F9ULL;
+    h ^= (unsigned long long)n->arg * 0x27D4EB2F165667C5ULL;
+    h ^= bits;
+    h ^= h >> 29;
+    return (unsigned long)h;
+}
+
+// Check whether two nodes compute the same value. Constants compare by bit
+// pattern so 0 and -0 stay distinct.
+static int opt_equal(const opt_node* x, const opt_node* y) {
+    return x->op == y->op && x->a == y->a && x->b == y->b && x->arg == y->arg &&
+           memcmp(&x->val, &y->val, sizeof(double)) == 0;
+}
+
+// Try to compute an operation whose operands are constants. Returns 0 when
+// the result must be left to run time, as for a zero divisor.
+static int opt_fold(int op, double left, double right, double* out) {
+    switch (op) {
+    case CCAL_OP_NEG: *out = -left; return 1;
+    case CCAL_OP_ADD: *out = left + right; return 1;
+    case CCAL_OP_SUB: *out = left - right; return 1;
+    case CCAL_OP_MUL: *out = left * right; return 1;
+    case CCAL_OP_DIV:
+        if (right == 0)
+            return 0;  // ccal_exec reports the division by zero
+        *out = left / right;
+        return 1;
+    case CCAL_OP_POW: {
+        int error = 0;
+        *out = apply_power(left, right, &error);
+        return !error;  // ccal_exec reports exponents without a real result
+    }
+    }
+    return 0;
+}
+
+// Working state of one optimizer run.
+typedef struct {
+    opt_node* nodes;
+    int count;
+    int* table;  // open-addressed hash set of node indexes, -1 when empty
+    unsigned long mask;
+} opt_graph;
+
+// Return the index of a node equal to n, adding n if it is new.
+static int opt_intern(opt_graph* g, const opt_node* n) {
+    unsigned long i = opt_hash(n) & g->mask;
+    while (g->table[i] >= 0) {
+        if (opt_equal(&g->nodes[g->table[i]], n))
+            return g->table[i];
+        i = (i + 1) & g->mask;
+    }
+    g->nodes[g->count] = *n;
+    g->nodes[g->count].uses = 0;
+    g->nodes[g->count].slot = -1;
+    g->table[i] = g->count;
+    return g->count++;
+}
+
+// Append one instruction to an optimized program; capacity is preallocated.
+static void opt_emit(ccal_program* out, int op, int arg, int* depth) {
+    out->code[out->code_len].op = op;
+    out->code[out->code_len].arg = arg;
+    out->code_len++;
+    if (op == CCAL_OP_CONST || op == CCAL_OP_COL || op == CCAL_OP_LOAD) {
+        if (++*depth > out->max_stack)
+            out->max_stack = *depth;
+    }
+    else if (is_binary_op(op)) {
+        --*depth;
+    }
+}
+
+// Fold constant subtrees and share repeated subtrees of a compiled program.
+// A subtree used more than once is computed once, kept in a temporary with
+// CCAL_OP_STORE and pushed again with CCAL_OP_LOAD. Returns 1 on success, 0
+// if memory ran out, in which case the program is left unchanged.
+static int optimize_program(ccal_program* prog) {
+    int n = prog->code_len;
+    unsigned long size = 16;
+    while (size < (unsigned long)n * 2)
+        size *= 2;
+
+    opt_graph g = { NULL, 0, NULL, size - 1 };
+    int* stack = malloc(n * sizeof(int));
+    int* todo = malloc(n * 2 * sizeof(int));
+    ccal_program out;
+    memset(&out, 0, sizeof(out));
+    g.nodes = malloc(n * sizeof(opt_node));
+    g.table = malloc(size * sizeof(int));
+    out.code = malloc(n * 2 * sizeof(ccal_insn));
+    out.consts = malloc(n * sizeof(double));
+    int ok = stack && todo && g.nodes && g.table && out.code && out.consts;
+    if (ok)
+        memset(g.table, -1, size * sizeof(int));
+
+    // Rebuild the expression graph, folding and interning as we go
+    int sp = 0;
+    for (int i = 0; ok && i < n; i++) {
+        const ccal_insn* in = &prog->code[i];
+        opt_node node = { in->op, -1, -1, 0, 0, 0, -1 };
+        if (in->op == CCAL_OP_CONST) {
+            node.val = prog->consts[in->arg];
+        }
+        else if (in->op == CCAL_OP_COL) {
+            node.arg = in->arg;
+        }
+        else {
+            if (is_binary_op(in->op))
+                node.b = stack[--sp];
+            node.a = stack[--sp];
+            const opt_node* x = &g.nodes[node.a];
+            const opt_node* y = node.b >= 0 ? &g.nodes[node.b] : NULL;
+            double val;
+            if (x->op == CCAL_OP_CONST && (!y || y->op == CCAL_OP_CONST) &&
+                opt_fold(in->op, x->val, y ? y->val : 0, &val)) {
+                node.op = CCAL_OP_CONST;
+                node.a = node.b = -1;
+                node.val = val;
+            }
+        }
+        int id = opt_intern(&g, &node);
+        if (node.a >= 0 && id == g.count - 1) {
+            g.nodes[node.a].uses++;
+            if (node.b >= 0)
+                g.nodes[node.b].uses++;
+        }
+        stack[sp++] = id;
+    }
+
+    // Emit postfix code again, depth first with an explicit stack so very
+    // long operator chains cannot overflow the C stack. Each entry is a
+    // node and how many of its operands are already emitted.
+    int depth = 0;
+    int top = 0;
+    if (ok) {
+        todo[top++] = stack[0];
+        todo[top++] = 0;
+    }
+    while (ok && top > 0) {
+        int id = todo[top - 2];
+        int done = todo[top - 1];
+        opt_node* node = &g.nodes[id];
+
+        if (done == 0 && node->slot >= 0) {
+            opt_emit(&out, CCAL_OP_LOAD, node->slot, &depth);
+            top -= 2;
+            continue;
+        }
+        if (node->op == CCAL_OP_CONST) {
+            out.consts[out.const_count] = node->val;
+            opt_emit(&out, CCAL_OP_CONST, out.const_count++, &depth);
+            top -= 2;
+            continue;
+        }
+        if (node->op == CCAL_OP_COL) {
+            opt_emit(&out, CCAL_OP_COL, node->arg, &depth);
+            top -= 2;
+            continue;
+        }
+
+        int child = done == 0 ? node->a : done == 1 ? node->b : -1;
+        if (child >= 0) {
+            todo[top - 1] = done + 1;
+            todo[top++] = child;
+            todo[top++] = 0;
+            continue;
+        }
+
+        opt_emit(&out, node->op, 0, &depth);
+        if (node->uses > 1) {
+            node->slot = out.temp_count++;
+            opt_emit(&out, CCAL_OP_STORE, node->slot, &depth);
+        }
+        top -= 2;
+    }
+
+    if (ok) {
+        // Temporaries and constants never outnumber the original code, so
+        // the optimized program always fits the buffers allocated above
+        free(prog->code);
+        free(prog->consts);
+        prog->code = out.code;
+        prog->code_len = out.code_len;
+        prog->code_cap = n * 2;
+        prog->consts = out.consts;
+        prog->const_count = out.const_count;
+        prog->const_cap = n;
+        prog->max_stack = out.max_stack;
+        prog->temp_count = out.temp_count;
+    }
+    else {
+        free(out.code);
+        free(out.consts);
+    }
+    free(stack);
+    free(todo);
+    free(g.nodes);
+    free(g.table);
+    return ok;
+}
+// Note 92 Interning each node as it is rebuilt makes identical subtrees collapse into one node, so a bracketed term repeated dozens of times is computed once and later uses just reload it.
+// Note 93 A division with a constant zero divisor is deliberately left unfolded, so the error still surfaces when the program runs, exactly where parse_term would have raised it.
+
+/*****************************************************************************
+*  GUI APPLICATION USEAGE:                                                   *
+*****************************************************************************/
+
+// GUI APPLICATION - SUPPORT FUNCTIONS:
+//////////////////////////////////////////////////////////////////////////////
+
+// Record the decimals of a number, as counted by scan_number, in the context.
+static void record_decimals(ccal_ctx* ctx, int count) {
+    if (count >= 0) {
+        ctx->hasDec = 1;
+        if (count > ctx->maxDec)
+            ctx->maxDec = count;
+    }
+}
+// Note 47 The quoted parser and the token parser share this helper, so both count decimals identically and their results format the same way.
+
+// Parse a number from the expression.
+ccal_num parse_number(ccal_ctx* ctx) {
+    CCAL_TRACE_HIT(CCAL_TRACE_OPERAND);
+    skip_spaces(ctx);
+    // Note 17 Every numeric parse begins by normalizing whitespace, mirroring lexical scanners that separate tokenization from grammar handling.
+
+    const char* end;
+    const char* start = ctx->expr_ptr;
+    if (start == ctx->expr_end) {
+        ctx->error = 1;
+        return num_of(0);
+    }
+    int count;
+    ccal_num val;
+    val.value = scan_number(start, ctx->expr_end, &end, &count, &val);
+
+    if (end == start) {
+        ctx->error = 1;
+        return num_of(0);
+    }
+    // Note 18 Returning an error when no digits are consumed prevents infinite loops where the caller would otherwise keep retrying at the same position.
+
+    // count number of decimal places
+    record_decimals(ctx, count);
+    // Note 19 Only digits after the point are counted, so scientific notation like 1e-3 would stop at 'e'; adapting to new formats would require extending scan_number.
+    // Note 20 Trailing zeros are trimmed the same way the formatter does it, teaching how evaluation and presentation share responsibilities in numeric software.
+
+    ctx->expr_ptr = end;
+    if (ctx->prog)
+        emit_const(ctx, val.value);
+    return val;
+}
+
+// Parse the $N column placeholder col, which only compiled programs can
+// resolve.
+static ccal_num parse_column(ccal_ctx* ctx, int col) {
+    if (!ctx->prog || col < 1 || col > CCAL_MAX_COLUMNS) {
+        ctx->error = 1;
+        return num_of(0);
+    }
+    if (col > ctx->prog->columns)
+        ctx->prog->columns = col;
+    emit_insn(ctx, CCAL_OP_COL, col - 1);
+    return num_of(0);
+}
+// Note 90 A column placeholder has no value until a row is supplied, so the parser only emits an instruction for it; the value returned while compiling is a throwaway.
+
+// Parse the word "ans" as the result the context binds to it, carrying its
+// precision as if its digits had been typed.
+static ccal_num parse_ans(ccal_ctx* ctx) {
+    const ccal_result* ans = ctx->ans;
+    if (ans->hasDec)
+        record_decimals(ctx, ans->maxDec);
+    if (ctx->prog)
+        emit_const(ctx, ans->value);
+    ccal_num val = { ans->value, ans->mant, ans->scale, ans->exact };
+    return val;
+}
+// Note 105 Handing the previous result over as a value rather than as the text it was printed as keeps every digit of it: 2^60 stays exact and 1.5/7 comes back to 1.5 when multiplied by 7, where reparsing the rounded display would not.
+
+// Open brackets wait on the operator stack as the character that closes
+// them, next to the CCAL_OP_* codes of pending operators.
+
+// Binding strength of a pending operator. Unary minus and open brackets
+// rank 0 because no operator reduces them; they end with their operand.
+static int op_rank(int op) {
+    switch (op) {
+    case CCAL_OP_ADD:
+    case CCAL_OP_SUB:
+        return 1;
+    case CCAL_OP_MUL:
+    case CCAL_OP_DIV:
+    case CCAL_OP_POW:
+        return 2;
+    default:
+        return 0;
+    }
+}
+// Note 23 Operator precedence lives in op_rank: multiplication, division and exponentiation outrank addition and subtraction, so they are reduced first, and operators of equal rank are reduced left to right.
+
+// Binary operator for the character c, 0 if c is not one.
+static int binary_op(char c) {
+    switch (c) {
+    case '+': return CCAL_OP_ADD;
+    case '-': return CCAL_OP_SUB;
+    case 'x': case 'X': case '*': return CCAL_OP_MUL;
+    case '/': return CCAL_OP_DIV;
+    case 'p': case 'P': case '^': return CCAL_OP_POW;
+    default: return 0;
+    }
+}
+// Note 66 Accepting both 'x' and '*' makes the calculator ergonomic on keyboards where typing '*' requires Shift, a thoughtful UX choice.
+
+// Tokens only a context can give meaning to, after the public kinds: a $N
+// column placeholder, with N in op, and the word ans.
+enum {
+    TOK_COLUMN = CCAL_TOK_BAD + 1,
+    TOK_ANS
+};
+
+// Reads the token at pos of the span [expr, expr + len) into *tok: with
+// operand set a unary minus, an open bracket or an operand, otherwise a
+// binary operator or a close bracket. Spaces and formatting characters
+// before it are skipped. $N is a TOK_COLUMN when ctx->columns is set and
+// ans a TOK_ANS when ctx->ans is. Returns the position after the token.
+static size_t read_token(const ccal_ctx* ctx, const char* expr, size_t len, size_t pos,
+                         int operand, ccal_token* tok) {
+    CCAL_TRACE_HIT(CCAL_TRACE_SKIP_SPACES);
+    const char* end = expr + len;
+    while (pos < len && (expr[pos] == ' ' || (is_format_char(expr[pos]) &&
+                                              !is_column_ref(ctx, expr + pos, end))))
+        pos++;
+    tok->start = pos;
+    tok->len = 1;
+    tok->op = 0;
+    if (pos == len) {
+        tok->kind = CCAL_TOK_END;
+        tok->len = 0;
+        return pos;
+    }
+
+    char c = expr[pos];
+    if (operand) {
+        if (c == '-') {
+            tok->kind = CCAL_TOK_NEG;
+        }
+        else if (c == '(' || c == '[' || c == '{') {
+            tok->kind = CCAL_TOK_OPEN;
+            tok->op = c == '(' ? ')' : c == '[' ? ']' : '}';
+        }
+        else if (c == '$') {
+            // a column; the number stops growing once it is out of range
+            tok->kind = TOK_COLUMN;
+            while (pos + tok->len < len && isdigit((unsigned char)expr[pos + tok->len])) {
+                if (tok->op <= CCAL_MAX_COLUMNS)
+                    tok->op = tok->op * 10 + (expr[pos + tok->len] - '0');
+                tok->len++;
+            }
+        }
+        else if (is_ans_ref(ctx, expr + pos, end)) {
+            tok->kind = TOK_ANS;
+            tok->len = 3;
+        }
+        else {
+            const char* stop;
+            tok->num.value = scan_number(expr + pos, end, &stop, &tok->decimals, &tok->num);
+            tok->kind = stop == expr + pos ? CCAL_TOK_BAD : CCAL_TOK_NUMBER;
+            if (tok->kind == CCAL_TOK_NUMBER)
+                tok->len = stop - (expr + pos);
+        }
+    }
+    else if (c == ')' || c == ']' || c == '}') {
+        tok->kind = CCAL_TOK_CLOSE;
+        tok->op = c;
+    }
+    else {
+        tok->op = binary_op(c);
+        tok->kind = tok->op ? CCAL_TOK_OP : CCAL_TOK_BAD;
+    }
+    return pos + tok->len;
+}
+// Note 107 A '$' reaches the column branch only when is_column_ref kept it from being skipped as formatting, and the word ans only matches when the context binds it, so without those settings the tokens are exactly the ones ccal_next_token hands out.
+
+// Value of the operand token tok: a number, a column or ans.
+static ccal_num parse_operand(ccal_ctx* ctx, const ccal_token* tok) {
+    switch (tok->kind) {
+    case CCAL_TOK_NUMBER:
+        CCAL_TRACE_HIT(CCAL_TRACE_OPERAND);
+        record_decimals(ctx, tok->decimals);
+        if (ctx->prog)
+            emit_const(ctx, tok->num.value);
+        return tok->num;
+    case TOK_COLUMN:
+        return parse_column(ctx, tok->op);
+    case TOK_ANS:
+        return parse_ans(ctx);
+    default:
+        ctx->error = 1;  // no operand where one is needed
+        return num_of(0);
+    }
+}
+
+// Stack entries parse_expr keeps in its own frame before moving to the
+// context's heap stacks.
+#define PARSE_STACK_LOCAL 64
+
+// Operand and operator stacks of one parse_expr call.
+typedef struct {
+    ccal_num* values;
+    int* ops;
+    int cap;  // entries available on each
+} parse_stack;
+
+// Make room for need entries on both stacks, moving them to the context's
+// heap stacks once they outgrow the caller's frame.
+static int grow_stacks(ccal_ctx* ctx, parse_stack* st, int need) {
+    if (need <= st->cap)
+        return 1;
+    CCAL_TRACE_HIT(CCAL_TRACE_STACK_GROW);
+    int local = st->values != ctx->values;
+    if (need > ctx->stack_cap) {
+        int cap = ctx->stack_cap ? ctx->stack_cap : PARSE_STACK_LOCAL;
+        while (cap < need)
+            cap *= 2;
+        ccal_num* values = realloc(ctx->values, cap * sizeof(ccal_num));
+        if (!values)
+            return 0;
+        ctx->values = values;
+        int* ops = realloc(ctx->ops, cap * sizeof(int));
+        if (!ops)
+            return 0;
+        ctx->ops = ops;
+        ctx->stack_cap = cap;
+    }
+    if (local) {
+        memcpy(ctx->values, st->values, st->cap * sizeof(ccal_num));
+        memcpy(ctx->ops, st->ops, st->cap * sizeof(int));
+    }
+    st->values = ctx->values;
+    st->ops = ctx->ops;
+    st->cap = ctx->stack_cap;
+    return 1;
+}
+
+// Apply the binary operator op to left and right, leaving the result in
+// left. While compiling only the instruction is emitted.
+static void apply_binary(ccal_ctx* ctx, int op, ccal_num* left, const ccal_num* right) {
+    CCAL_TRACE_HIT(CCAL_TRACE_REDUCE);
+    if (ctx->prog) {
+        // divisors and exponents are checked when the program runs
+        emit_insn(ctx, op, 0);
+        return;
+    }
+    switch (op) {
+    case CCAL_OP_ADD:
+        left->value += right->value;
+        exact_add(left, right, 0);
+        break;
+    case CCAL_OP_SUB:
+        left->value -= right->value;
+        exact_add(left, right, 1);
+        break;
+    case CCAL_OP_MUL:
+        left->value *= right->value;
+        exact_mul(left, right);
+        break;
+    case CCAL_OP_DIV:
+        if (num_is_zero(right)) {
+            ctx->error = 1;  // division by zero error
+            return;
+        }
+        left->value /= right->value;
+        exact_div(left, right);
+        // Note 67 Division stays exact only while the quotient terminates, as 10/4 does; 1/3 falls back to floating-point, so even integer inputs can yield fractional results, reinforcing why formatting must adapt dynamically.
+        break;
+    case CCAL_OP_POW:
+        if (num_is_zero(left) && right->value < 0)
+            ctx->error = 1;  // same as dividing by zero
+        left->value = apply_power(left->value, right->value, &ctx->error);
+        if (!ctx->error)
+            exact_pow(left, right);
+        // Note 68 Whole-number exponents are computed by squaring while fractional ones such as 2^0.5 go through pow, so roots work without giving up exact results for the common integer case.
+        break;
+    }
+}
+// Note 24 The explicit division-by-zero check produces a clean parser error instead of relying on IEEE exceptions, which keeps feedback consistent across platforms.
+// Note 25 Exponentiation follows the usual conventions: anything to the power 0 is 1, a negative exponent is a reciprocal, and 0 to a negative power is rejected just like a division by zero.
+
+// Parse and evaluate (or compile) the expression at the cursor. The tokens
+// read_token finds are pushed on explicit stacks and reduced in
+// precedence order: x, /, p and ^ bind tighter than + and -, operators of
+// equal rank apply left to right, and unary minus applies to the single
+// operand after it. Brackets and unary minuses may nest ctx->max_depth deep.
+ccal_num parse_expr(ccal_ctx* ctx) {
+    ccal_num local_values[PARSE_STACK_LOCAL];
+    int local_ops[PARSE_STACK_LOCAL];
+    parse_stack st = { local_values, local_ops, PARSE_STACK_LOCAL };
+    int ops = 0;      // entries on st.ops
+    int vals = 0;     // entries on st.values
+    int nesting = 0;  // open brackets and unary minuses on st.ops
+    const char* expr = ctx->expr_ptr;
+    size_t len = ctx->expr_end - expr;
+    size_t pos = 0;   // start of the first token not consumed
+    ccal_token tok;
+
+    while (!ctx->error) {
+        // Operand: any unary minuses and open brackets, then a number, column or ans
+        size_t next = read_token(ctx, expr, len, pos, 1, &tok);
+        pos = tok.start;
+        // Note 52 Each token is read knowing whether an operand or an operator is due, which is what lets '-' be a unary minus in one place and a subtraction in the other.
+        if (tok.kind == CCAL_TOK_NEG || tok.kind == CCAL_TOK_OPEN) {
+            if (++nesting > ctx->max_depth || !grow_stacks(ctx, &st, ops + 1)) {
+                ctx->error = 1;
+                break;
+            }
+            CCAL_TRACE_HIT(CCAL_TRACE_OPEN);
+            CCAL_TRACE_DEPTH(nesting);
+            st.ops[ops++] = tok.kind == CCAL_TOK_NEG ? CCAL_OP_NEG : tok.op;
+            pos = next;
+            continue;
+        }
+        // Note 64 Where recursive descent would call itself for a nested group, the bracket is pushed on a heap-backed stack instead, so a million '(' or '-' characters hit max_depth rather than overflowing the thread's C stack.
+        ccal_num val = parse_operand(ctx, &tok);
+        if (ctx->error || !grow_stacks(ctx, &st, vals + 1)) {
+            ctx->error = 1;
+            break;
+        }
+        st.values[vals++] = val;
+        pos = next;
+
+        // Close the groups and unary minuses this operand completes
+        for (;;) {
+            while (ops > 0 && st.ops[ops - 1] == CCAL_OP_NEG) {
+                st.values[vals - 1].value = -st.values[vals - 1].value;
+                exact_neg(&st.values[vals - 1]);
+                if (ctx->prog)
+                    emit_insn(ctx, CCAL_OP_NEG, 0);
+                ops--;
+                nesting--;
+            }
+            // Note 65 A unary minus waits on the stack until its operand is complete and is applied right away, so -(-3) still resolves to +3 and -2^2 squares -2.
+            next = read_token(ctx, expr, len, pos, 0, &tok);
+            pos = tok.start;
+            if (tok.kind != CCAL_TOK_CLOSE)
+                break;
+            while (ops > 0 && op_rank(st.ops[ops - 1]) && !ctx->error) {
+                ops--;
+                vals--;
+                apply_binary(ctx, st.ops[ops], &st.values[vals - 1], &st.values[vals]);
+            }
+            if (ctx->error || ops == 0)
+                break;  // a stray close bracket is left for the caller
+            if (st.ops[ops - 1] != tok.op) {
+                ctx->error = 1;  // brackets do not match
+                break;
+            }
+            ops--;
+            nesting--;
+            pos = next;  // skip closing bracket
+        }
+        // Note 21 Allowing three bracket styles makes the parser friendlier to clipboard input from spreadsheets or programming languages; the matching check guards against silent math errors when the user mistypes.
+        // Note 69 A close bracket with no open bracket on the stack simply ends the expression; the caller then finds unconsumed input and reports the error, exactly as a recursive parser would.
+
+        // Operator: reduce pending operators of equal or higher rank first
+        if (ctx->error || tok.kind != CCAL_TOK_OP)
+            break;
+        int op = tok.op;
+        pos = next;
+        // Note 53 Moving pos past the operator consumes it, so the next pass of the loop reads the remainder of the expression without extra bookkeeping.
+        while (ops > 0 && op_rank(st.ops[ops - 1]) >= op_rank(op) && !ctx->error) {
+            ops--;
+            vals--;
+            apply_binary(ctx, st.ops[ops], &st.values[vals - 1], &st.values[vals]);
+        }
+        // Note 26 Reducing a pending operator of equal rank before pushing the new one is what makes 10-3-2 mean (10-3)-2 and 2^3^2 mean (2^3)^2.
+        CCAL_TRACE_HIT(CCAL_TRACE_SHIFT);
+        if (!grow_stacks(ctx, &st, ops + 1))
+            ctx->error = 1;
+        else
+            st.ops[ops++] = op;
+        // Note 16 Every operator waits on the stack until an operator of lower or equal rank, a close bracket or the end of the input proves its right-hand side complete.
+    }
+    ctx->expr_ptr = expr + pos;
+
+    // End of input: reduce what is left; an open bracket was never closed
+    while (!ctx->error && ops > 0) {
+        if (!op_rank(st.ops[ops - 1])) {
+            ctx->error = 1;
+            break;
+        }
+        ops--;
+        vals--;
+        apply_binary(ctx, st.ops[ops], &st.values[vals - 1], &st.values[vals]);
     }
-    else {
-        // Note 51 When offDec is clear we honor user formatting, treating decimal places as significant unless they are trailing zeros beyond cents precision.
-        if (dot && dot < end) {
-            hasDec = 1;
-            int count = 0;
-            const char* p = dot + 1;
-            while (p < end && isdigit(*p)) {
-                count++;
-                p++;
-            }
+    return ctx->error ? num_of(0) : st.values[0];
+}
+// Note 22 Treating unary minus as a prefix of a single operand keeps the grammar simple: a factor can become negative without separate tokens or precedence rules.
+// Note 54 Ordinary expressions never leave the small stacks in parse_expr's frame; deeper ones move to heap stacks the context keeps, so a worker evaluating millions of lines allocates them at most once.
+// Note 27 Unlike the recursive version, memory for nesting grows on the heap and is bounded by max_depth, which lets the parser reject hostile input with the same clean error as any other mistake.
 
-            // trim trailing zeros
-            if (count > 2) {
-                const char* t = end - 1;
-                while (count > 2 && *t == '0') {
-                    count--;
-                    t--;
-                }
-            }
+// TOKENS:
+//////////////////////////////////////////////////////////////////////////////
+
+// Reads the token at pos of the span [expr, expr + len) into *tok, exactly
+// as parse_expr would: with operand set a unary minus, an open bracket or a
+// number, otherwise a binary operator or a close bracket. Spaces and
+// formatting characters before it are skipped; anything the parser would
+// reject is a one-character CCAL_TOK_BAD. tok->look tells how far reading
+// it looked, so a caller keeping tokens knows which edits can change them.
+// Returns the position after the token.
+size_t ccal_next_token(const char* expr, size_t len, size_t pos, int operand,
+                       ccal_token* tok) {
+    static const ccal_ctx plain;  // no columns, no ans
+    size_t next = read_token(&plain, expr, len, pos, operand, tok);
+    tok->look = tok->start + 1;
+    if (operand && (tok->kind == CCAL_TOK_NUMBER || tok->kind == CCAL_TOK_BAD))
+        tok->look = number_extent(expr + tok->start, expr + len) - expr + 1;
+    return next;
+}
 
-            if (count > *num)
-                *num = count;
+// Kind and code of each character as a whole command line argument, for
+// ccal_lex_argv; characters left out are numbers.
+static const struct {
+    unsigned char kind;
+    unsigned char op;
+} argv_symbols[256] = {
+    ['+'] = { CCAL_TOK_OP, CCAL_OP_ADD }, ['-'] = { CCAL_TOK_OP, CCAL_OP_SUB },
+    ['x'] = { CCAL_TOK_OP, CCAL_OP_MUL }, ['X'] = { CCAL_TOK_OP, CCAL_OP_MUL },
+    ['/'] = { CCAL_TOK_OP, CCAL_OP_DIV },
+    ['p'] = { CCAL_TOK_OP, CCAL_OP_POW }, ['P'] = { CCAL_TOK_OP, CCAL_OP_POW },
+    ['('] = { CCAL_TOK_OPEN, ')' }, ['['] = { CCAL_TOK_OPEN, ']' }, ['{'] = { CCAL_TOK_OPEN, '}' },
+    [')'] = { CCAL_TOK_CLOSE, ')' }, [']'] = { CCAL_TOK_CLOSE, ']' }, ['}'] = { CCAL_TOK_CLOSE, '}' }
+};
+
+// Reads each command line argument into toks[i], as the argv evaluator
+// sees it: a lone + - x X p P or / is a CCAL_TOK_OP, a lone bracket a
+// CCAL_TOK_OPEN or CCAL_TOK_CLOSE, an argument scan_number reads to its
+// end, spaces and formatting characters aside, a CCAL_TOK_NUMBER, and
+// anything else, such as 5abc or 1.2.3, a CCAL_TOK_BAD. start is 0 and len
+// the argument's length.
+void ccal_lex_argv(int argc, char* argv[], ccal_token* toks) {
+    for (int i = 0; i < argc; i++) {
+        const char* s = argv[i];
+        ccal_token* tok = &toks[i];
+        tok->start = 0;
+        if (s[0] != '\0' && s[1] == '\0' && argv_symbols[(unsigned char)s[0]].kind) {
+            tok->kind = argv_symbols[(unsigned char)s[0]].kind;
+            tok->op = argv_symbols[(unsigned char)s[0]].op;
+            tok->len = 1;
+            tok->look = 1;
+            continue;
         }
-        // Note 80 Advancing the scanning pointer ensures the next iteration evaluates the remainder of the expression, eventually terminating when we reach '\0'.
+        const char* stop;
+        tok->op = 0;
+        tok->len = strlen(s);
+        tok->look = tok->len;
+        tok->num.value = scan_number(s, s + tok->len, &stop, &tok->decimals, &tok->num);
+        const char* rest = stop;
+        while (rest < s + tok->len && (isspace((unsigned char)*rest) || is_format_char(*rest)))
+            rest++;
+        tok->kind = stop != s && rest == s + tok->len ? CCAL_TOK_NUMBER : CCAL_TOK_BAD;
+    }
+}
+// Note 29 Each argument is classified and its number read once, before evaluation starts, so the argv evaluator compares small integer codes instead of strings and shares operator codes, and the arithmetic behind them, with the quoted parser.
+// Note 30 Treating all bracket styles uniformly keeps the CLI behavior aligned with the GUI, making automated tests easier to write; "*" is left out because an unquoted one is expanded by the shell, which is why -q exists.
+
+// Applies op to left and right the way parse_expr does, leaving the result
+// in left; CCAL_OP_NEG negates left and ignores right. Returns 0, with left
+// set to 0, for a zero divisor or a power with no real result.
+int ccal_apply(int op, ccal_num* left, const ccal_num* right) {
+    if (op == CCAL_OP_NEG) {
+        left->value = -left->value;
+        exact_neg(left);
+        return 1;
     }
+    ccal_ctx ctx;
+    ccal_ctx_init(&ctx);
+    apply_binary(&ctx, op, left, right);
+    if (ctx.error)
+        *left = num_of(0);
+    return !ctx.error;
+}
 
-    expr_ptr = end;
+// Settles the double of a finished result to its exact value, as every
+// evaluator does before returning.
+void ccal_settle(ccal_num* num) {
+    num_settle(num);
 }
-// Note 8 Tracking the maximum decimals while walking the expression lets the formatter respect user intent—notice how trailing zeros are trimmed only beyond two places to balance fidelity and readability.
+// Note 101 These three functions are the parser taken apart: a caller that keeps tokens and partial results between calls, such as the incremental evaluator, lexes and combines them with the very code parse_expr runs, so it can never disagree with a full evaluation.
 
-// Format the final output based on decimal precision found in the expression.
-void FormatOutput(const char* expr, double result, char* fin_str) {
-    if (offDec == 1) {
-        hasDec = 0;
-        maxDec = 0;
-        snprintf(fin_str, 64, "%.16g", result);
-        return;
-    }
-    // Note 9 The offDec flag short-circuits formatting for operations like multiplication where scientific precision matters more than user-friendly grouping.
+// RESULT CACHE:
+//////////////////////////////////////////////////////////////////////////////
 
-    int localHasDec = 0;
-    int localMaxDec = 0;
-    const char* p = expr;
+// Characters a space next to can be dropped from a cache key: nothing the
+// parser reads can continue through them.
+static int is_key_tight(char c) {
+    return c == '(' || c == ')' || c == '[' || c == ']' || c == '{' || c == '}' ||
+           c == '*' || c == '/' || c == '^';
+}
 
-    while (*p) {
-        while (*p == ' ' || *p == '\t')
-            ++p;
-        // Note 10 Skipping spaces on every iteration keeps the scanner tolerant of user formatting, mirroring the approach used by the parser itself.
-        // Note 79 Only space and tab are handled because command-line parsing from argv strips other whitespace characters, simplifying the normalization logic.
+// Check for the last character of an operand, after which + and - are binary.
+static int is_key_operand_end(char c) {
+    return isdigit((unsigned char)c) || c == '.' || c == ')' || c == ']' || c == '}';
+}
 
-        char* end;
-        strtod(p, &end);
-        if (end == p) {
-            if (*p == '\0')
-                break;
-            ++p;
+// Check whether an x or p written after key[0, n) can only be the operator:
+// it must follow an operand other than a leading 0, which would start a hex
+// number, and p must not be the exponent of a hex number seen earlier.
+static int is_key_operator(const char* key, int n, char c, int hex) {
+    if (n == 0 || !is_key_operand_end(key[n - 1]))
+        return 0;
+    if (key[n - 1] == '0' && (n == 1 || !(isdigit((unsigned char)key[n - 2]) || key[n - 2] == '.')))
+        return 0;
+    return c == 'x' || c == 'X' || !hex;
+}
+
+// Write the canonical form of the expression span [p, p + len) to key:
+// formatting characters dropped, runs of spaces collapsed and spaces
+// trimmed wherever the parser could not tell the difference. Returns the
+// key length, or -1 when the span has no key, because it is too long or
+// holds words such as inf, nan or hex digits whose spacing matters.
+static int cache_key(const char* p, size_t len, char* key) {
+    const char* end = p + len;
+    int n = 0;
+    int space = 0;       // spaces seen since the last character kept
+    int binary = 0;      // the last character kept is a binary + or -
+    int oper = 0;        // the last character kept is an x or p operator
+    int hex = 0;         // an x that may start a hex number was kept
+    for (; p < end; p++) {
+        char c = *p;
+        if (is_format_char(c))
+            continue;
+        if (c == ' ') {
+            space = n > 0;
             continue;
         }
-        // Note 11 Using strtod here avoids hand-written numeric parsing and automatically supports locale-independent decimal notation required by the calculator.
-        // Note 78 If strtod fails, we advance by one character to avoid getting stuck—this mirrors primitive lexers that recover by skipping unknown symbols.
-
-        const char* dot = NULL;
-        for (const char* q = p; q < end; ++q) {
-            if (*q == '.') {
-                dot = q;
-                break;
+        if (isalpha((unsigned char)c) && !strchr("xXpPeE", c))
+            return -1;
+
+        int letter = c == 'x' || c == 'X' || c == 'p' || c == 'P';
+        int op = letter && is_key_operator(key, n, c, hex);
+        if (space) {
+            char prev = key[n - 1];
+            int drop;
+            if (letter)
+                drop = op;
+            else if (isalpha((unsigned char)c))
+                drop = 0;
+            else if (oper)
+                drop = 1;
+            else
+                drop = !isalpha((unsigned char)prev) &&
+                       (is_key_tight(prev) || is_key_tight(c) || binary ||
+                        ((c == '+' || c == '-') && is_key_operand_end(prev)));
+            if (!drop) {
+                if (n == CCAL_CACHE_KEY_MAX)
+                    return -1;
+                key[n++] = ' ';
             }
+            space = 0;
         }
+        if (n == CCAL_CACHE_KEY_MAX)
+            return -1;
+        binary = (c == '+' || c == '-') && n > 0 && is_key_operand_end(key[n - 1]);
+        oper = op;
+        hex |= (c == 'x' || c == 'X') && !op;
+        key[n++] = c;
+    }
+    return n;
+}
+// Note 97 Every rule above only removes a space the parser would skip anyway: a bracket, *, / or ^ ends any number, a + or - straight after an operand is always the binary operator, and an x or p is only joined to its operands when it cannot be read as part of a hex number.
+
+// FNV-1a hash of a cache key.
+static unsigned long long cache_hash(const char* key, int len) {
+    unsigned long long h = 14695981039346656037ULL;
+    for (int i = 0; i < len; i++) {
+        h ^= (unsigned char)key[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
 
-        if (dot) {
-            localHasDec = 1;
-            int count = 0;
-            const char* s = dot + 1;
-            while (s < end && isdigit((unsigned char)*s)) {
-                ++count;
-                ++s;
-            }
-            // Note 12 Counting digits after the decimal helps decide whether to keep precision or clamp to two decimals for currency-style outputs.
+// Create a result cache using at most max_bytes of memory. Returns 1 on
+// success, 0 if the budget holds no entry or memory is short, leaving the
+// cache off so ccal_cache_evaluate just evaluates.
+int ccal_cache_init(ccal_cache* cache, size_t max_bytes) {
+    memset(cache, 0, sizeof(*cache));
+
+    // every slot costs one entry and at most two bucket heads
+    size_t slots = max_bytes / (sizeof(ccal_cache_entry) + 2 * sizeof(int));
+    if (slots > INT_MAX / 4)
+        slots = INT_MAX / 4;
+    if (slots == 0)
+        return 0;
+    size_t buckets = 1;
+    while (buckets < slots)
+        buckets *= 2;
+
+    cache->entries = malloc(slots * sizeof(ccal_cache_entry));
+    cache->buckets = malloc(buckets * sizeof(int));
+    if (!cache->entries || !cache->buckets) {
+        ccal_cache_free(cache);
+        return 0;
+    }
+    memset(cache->buckets, -1, buckets * sizeof(int));
+    cache->capacity = (int)slots;
+    cache->bucket_mask = (int)buckets - 1;
+    return 1;
+}
 
-            if (count > 2) {
-                const char* t = end - 1;
-                while (count > 2 && *t == '0') {
-                    --count;
-                    --t;
-                }
-                // Note 62 This backward scan prevents numbers like 3.1400 from being reported with four decimals when only two carry meaning, a nuance finance learners often appreciate.
-            }
-            // Note 13 Trimming trailing zeros illustrates a common formatting compromise: align with human expectations without losing core numeric intent.
+// Release a result cache. It is off afterwards and may be created again.
+void ccal_cache_free(ccal_cache* cache) {
+    free(cache->entries);
+    free(cache->buckets);
+    memset(cache, 0, sizeof(*cache));
+}
 
-            if (count > localMaxDec)
-                localMaxDec = count;
-        }
+// Pick the slot for a new entry: a free one while there is room, otherwise
+// the first entry the CLOCK hand finds unused since its last pass, which is
+// unlinked from its hash chain.
+static int cache_victim(ccal_cache* cache) {
+    if (cache->used < cache->capacity)
+        return cache->used++;
 
-        p = end;
+    while (cache->entries[cache->hand].ref) {
+        cache->entries[cache->hand].ref = 0;
+        cache->hand = (cache->hand + 1) % cache->capacity;
     }
-
-    if (!localHasDec) {
-        hasDec = 0;
-        maxDec = 0;
-        snprintf(fin_str, 64, "%.16g", result);
+    int slot = cache->hand;
+    cache->hand = (cache->hand + 1) % cache->capacity;
+
+    ccal_cache_entry* old = &cache->entries[slot];
+    int* link = &cache->buckets[old->hash & cache->bucket_mask];
+    while (*link != slot)
+        link = &cache->entries[*link].next;
+    *link = old->next;
+    cache->evictions++;
+    return slot;
+}
+// Note 98 CLOCK approximates least-recently-used eviction with one bit per entry instead of a linked list, so a hit only sets a flag and never reorders anything, and entries read again since the hand last passed get a second chance.
+
+// Evaluates the expression span [expr, expr + len) like ccal_evaluate_result,
+// answering from the cache when an expression with the same canonical text
+// was evaluated before. Invalid expressions are remembered too. The cache
+// must only be shared by contexts with the same nesting limit.
+ccal_result ccal_cache_evaluate(ccal_cache* cache, ccal_ctx* ctx, const char* expr,
+                                size_t len, int* error) {
+    char key[CCAL_CACHE_KEY_MAX];
+    int key_len = cache->capacity ? cache_key(expr, len, key) : -1;
+    if (key_len < 0) {
+        if (cache->capacity)
+            cache->misses++;
+        return ccal_evaluate_result(ctx, expr, len, error);
     }
-    else {
-        hasDec = 1;
-        maxDec = localMaxDec;
-        
-        // Format with appropriate precision first
-        char temp_str[64];
-        if (maxDec <= 2)
-            snprintf(temp_str, 64, "%.2f", result);
-        else
-            snprintf(temp_str, 64, "%.*f", maxDec, result);
-            
-        // Check if the result is effectively an integer (decimal part is all zeros)
-        char* dot_pos = strchr(temp_str, '.');
-        if (dot_pos != NULL) {
-            // Check if all characters after decimal point are zeros
-            char* p = dot_pos + 1;
-            int all_zeros = 1;
-            while (*p != '\0') {
-                if (*p != '0') {
-                    all_zeros = 0;
-                    break;
-                }
-                p++;
-            }
-            
-            // If all decimal digits are zeros, format as integer
-            if (all_zeros) {
-                // Extract the integer part and format without decimal
-                *dot_pos = '\0';  // Terminate string at decimal point
-                strcpy(fin_str, temp_str);
-            } else {
-                strcpy(fin_str, temp_str);
-            }
-        } else {
-            strcpy(fin_str, temp_str);
+
+    unsigned long long hash = cache_hash(key, key_len);
+    int* bucket = &cache->buckets[hash & cache->bucket_mask];
+    for (int i = *bucket; i >= 0; i = cache->entries[i].next) {
+        ccal_cache_entry* e = &cache->entries[i];
+        if (e->hash == hash && e->key_len == key_len && memcmp(e->key, key, key_len) == 0) {
+            e->ref = 1;
+            cache->hits++;
+            ctx->hasDec = e->res.hasDec;
+            ctx->maxDec = e->res.maxDec;
+            ctx->offDec = e->res.offDec;
+            ctx->error = e->error;
+            *error = e->error;
+            return e->res;
         }
-        // Note 63 Leveraging snprintf with a precision field (%.*f) is a powerful technique when formatting rules depend on runtime analysis rather than fixed templates.
     }
-}
-// Note 14 The conditional at the end keeps integer results compact while still honoring high-precision operands, showcasing a user-centric formatting strategy.
 
-// Calculate power of call.
-double power_of(double base, int expo) {
-    double mathOut = base;
-    for (int j = 1; j < expo; j++) {
-        base = mathOut * base;
-    }
-    return base;
+    cache->misses++;
+    ccal_result res = ccal_evaluate_result(ctx, expr, len, error);
+    int slot = cache_victim(cache);
+    ccal_cache_entry* e = &cache->entries[slot];
+    e->hash = hash;
+    e->key_len = (unsigned char)key_len;
+    e->ref = 0;
+    e->error = (unsigned char)*error;
+    e->res = res;
+    memcpy(e->key, key, key_len);
+    e->next = *bucket;
+    *bucket = slot;
+    return res;
 }
-// Note 15 This simple loop avoids pow from math.h, sidestepping floating-point rounding differences that could complicate regression testing.
 
-/*****************************************************************************
-*  GUI APPLICATION USEAGE:                                                   *
-*****************************************************************************/
-
-// GUI APPLICATION - SUPPORT FUNCTIONS:
+// GUI APPLICATION - MAIN FUNCTION:
 //////////////////////////////////////////////////////////////////////////////
 
-// Shift elements in parse_term function for handling gui and -q, --quote.
-double shift_parse(int* error) {
-    expr_ptr++;
-    return parse_factor(error);
+// Evaluates the expression span [expr, expr + len) into a number whose
+// double is settled to its exact value when there is one.
+static ccal_num evaluate_span_num(ccal_ctx* ctx, const char* expr, size_t len, int* error) {
+    CCAL_PROBE1(expr__start, len);
+    CCAL_PROBE_CLOCK(probe_start, expr__end);
+    ctx->error = 0;
+    ctx->expr_ptr = expr;  // initialize context cursor to start of expression
+    ctx->expr_end = expr + len;
+    ccal_num result = parse_expr(ctx);
+    skip_spaces(ctx);
+    // Note 70 Trailing spaces are ignored so that copying expressions from text editors does not inadvertently trigger parse errors.
+    // if there are leftover characters after parsing, error
+    if (ctx->expr_ptr != ctx->expr_end)
+        ctx->error = 1;
+    *error = ctx->error;
+    if (ctx->error) {
+        CCAL_PROBE2(parse__error, len, (size_t)(ctx->expr_ptr - expr));
+        result = num_of(0);
+    }
+    else
+        num_settle(&result);
+    CCAL_PROBE4(expr__end, len, ccal_probe_bits(result.value), ctx->error,
+                CCAL_PROBE_ELAPSED(probe_start));
+    return result;
+}
+// Note 104 The probes are a few nops in the binary until a tracer attaches; only then do they read the clock, so production processes can be measured live without a special build.
+
+// Evaluates the expression span [expr, expr + len) within a context and
+// returns result. The span needs no terminator and may still contain the
+// formatting characters remove_format strips. If error occurs, *error is set
+// to 1.
+double ccal_evaluate_span(ccal_ctx* ctx, const char* expr, size_t len, int* error) {
+    return evaluate_span_num(ctx, expr, len, error).value;
+}
+
+// Parses a span holding exactly one number, such as a CSV field, and records
+// its decimals in the context. Unlike ccal_evaluate, operators are not
+// accepted, so text like a date is rejected rather than computed. If error
+// occurs, *error is set to 1.
+double ccal_parse_number(ccal_ctx* ctx, const char* str, size_t len, int* error) {
+    ctx->error = 0;
+    ctx->expr_ptr = str;
+    ctx->expr_end = str + len;
+    double result = parse_number(ctx).value;
+    skip_spaces(ctx);
+    if (ctx->expr_ptr != ctx->expr_end)
+        ctx->error = 1;
+    *error = ctx->error;
+    return ctx->error ? 0 : result;
 }
-// Note 16 Advancing expr_ptr past an operator before parsing the right-hand side keeps parse_term concise and emphasizes that token consumption happens at the higher-precedence caller.
 
-// Parse a number from the expression.
-double parse_number(int* error) {
-    skip_spaces();
-    // Note 17 Every numeric parse begins by normalizing whitespace, mirroring lexical scanners that separate tokenization from grammar handling.
+// Evaluates the expression span [expr, expr + len) and returns its value
+// together with the precision of its operands. If error occurs, *error is
+// set to 1.
+ccal_result ccal_evaluate_result(ccal_ctx* ctx, const char* expr, size_t len, int* error) {
+    ctx->hasDec = 0;
+    ctx->maxDec = 0;
+    ctx->offDec = 0;
+    ccal_num num = evaluate_span_num(ctx, expr, len, error);
+    ccal_result res = { num.value, ctx->hasDec, ctx->maxDec, ctx->offDec,
+                        num.mant, num.scale, num.exact };
+    return res;
+}
+// Note 57 parse_number already counts decimals as it consumes each operand, so collecting them into the record is free compared with scanning the text a second time.
 
-    char* end;
-    const char* start = expr_ptr;
-    double val = strtod(expr_ptr, &end);
+// Evaluates an expression string within a context and returns result. If
+// error occurs, *error is set to 1.
+double ccal_evaluate(ccal_ctx* ctx, const char* expr, int* error) {
+    return ccal_evaluate_span(ctx, expr, strlen(expr), error);
+}
+// Note 28 Resetting the cursor at the entry point lets you reuse the same parsing machinery for both GUI input and command-line expressions without reinitializing state elsewhere.
 
-    if (end == start) {
-        *error = 1;
-        return 0;
+// Evaluates an expression string using the default context. If error occurs,
+// *error is set to 1.
+double evaluate_expr_string(const char* expr, int* error) {
+    load_default_ctx();
+    double result;
+    if (default_cache.capacity) {
+        // a cached result carries one expression's precision; fold it into
+        // the running totals the way parsing the expression would have
+        int has = default_ctx.hasDec;
+        int max = default_ctx.maxDec;
+        int off = default_ctx.offDec;
+        ccal_result res = ccal_cache_evaluate(&default_cache, &default_ctx, expr,
+                                              strlen(expr), error);
+        default_ctx.hasDec = res.hasDec ? 1 : has;
+        default_ctx.maxDec = res.maxDec > max ? res.maxDec : max;
+        default_ctx.offDec = off;
+        result = res.value;
     }
-    // Note 18 Returning an error when no digits are consumed prevents infinite loops where the caller would otherwise keep retrying at the same position.
+    else {
+        result = ccal_evaluate(&default_ctx, expr, error);
+    }
+    store_default_ctx();
+    return result;
+}
 
-    // count number of decimal places
-    const char* dot = strchr(start, '.');
-    if (dot && dot < end) {
-        hasDec = 1;
-        int count = 0;
-        const char* p = dot + 1;
-        while (p < end) {
-            if (*p < '0' || *p > '9') break;
-            count++;
-            p++;
-        }
-        // Note 19 The loop counts only digits, so scientific notation like 1e-3 would stop at 'e'; adapting to new formats would require extending this branch.
+// Put a result cache of at most max_bytes in front of evaluate_expr_string,
+// replacing any earlier one, or turn it off when max_bytes is 0. Returns 1
+// if the cache is on.
+int expr_cache_enable(size_t max_bytes) {
+    ccal_cache_free(&default_cache);
+    return max_bytes ? ccal_cache_init(&default_cache, max_bytes) : 0;
+}
 
-        // check trailing zeros
-        const char* t = end - 1;
-        while (count > 2 && *t == '0') {
-            count--;
-            t--;
-        }
-        // Note 20 This trimming mirrors the formatting rules, teaching how evaluation and presentation share responsibilities in numeric software.
+// Hit, miss and eviction counters of the cache behind evaluate_expr_string.
+const ccal_cache* expr_cache_stats(void) {
+    return &default_cache;
+}
 
-        if (count > maxDec)
-            maxDec = count;
-    }
+// COMPILED EXPRESSIONS - COMPILE AND EXECUTE:
+//////////////////////////////////////////////////////////////////////////////
 
-    expr_ptr = end;
-    return val;
+// Compile an expression string into a bytecode program. Returns 1 on
+// success, 0 if the expression is invalid.
+int ccal_compile(ccal_ctx* ctx, const char* expr, ccal_program* prog) {
+    memset(prog, 0, sizeof(*prog));
+    ctx->error = 0;
+    ctx->expr_ptr = expr;
+    ctx->expr_end = expr + strlen(expr);
+    ctx->prog = prog;
+    ctx->depth = 0;
+    parse_expr(ctx);
+    skip_spaces(ctx);
+    if (ctx->expr_ptr != ctx->expr_end)
+        ctx->error = 1;
+    ctx->prog = NULL;
+
+    if (ctx->error) {
+        ccal_program_free(prog);
+        return 0;
+    }
+    optimize_program(prog);  // on failure the unoptimized program still runs
+    prog->hasDec = ctx->hasDec;
+    prog->maxDec = ctx->maxDec;
+    prog->offDec = ctx->offDec;
+    return 1;
 }
+// Note 86 Compiling runs the very same grammar functions as evaluation, so a compiled program can never accept or reject different input than evaluate_expr_string.
 
-// Parse expressions with parentheses or brackets: (), [], {}.
-double parse_paren(int* error) {
-    skip_spaces();
-    if (*expr_ptr == '(' || *expr_ptr == '[' || *expr_ptr == '{') {
-        char open = *expr_ptr++;         // remember opening bracket and move forward
-        double val = parse_expr(error);  // recursively parse inner expression
-    // Note 64 Recursive descent shines here: handling nested groups is as straightforward as calling parse_expr again, with the call stack tracking context for us.
-        skip_spaces();
-        char close = *expr_ptr;
-        // check matching closing bracket
-        if ((open == '(' && close != ')') ||
-            (open == '[' && close != ']') ||
-            (open == '{' && close != '}')) {
+// Size of the value stack ccal_exec keeps on the C stack.
+#define EXEC_STACK_SIZE 64
+
+// Run a compiled program and return its result. If error occurs, *error is
+// set to 1.
+double ccal_exec(const ccal_program* prog, int* error) {
+    double local[EXEC_STACK_SIZE];
+    double* stack = local;
+    *error = 0;
+    if (prog->max_stack + prog->temp_count > EXEC_STACK_SIZE) {
+        stack = malloc((prog->max_stack + prog->temp_count) * sizeof(double));
+        if (!stack) {
             *error = 1;
             return 0;
         }
-        expr_ptr++; // skip closing bracket
-        return val;
     }
-    // no bracket found, parse a number instead
-    return parse_number(error);
-}
-// Note 21 Allowing three bracket styles makes the parser friendlier to clipboard input from spreadsheets or programming languages; the matching check guards against silent math errors when the user mistypes.
-
-// Parse factors, handle unary minus.
-double parse_factor(int* error) {
-    skip_spaces();
-    if (*expr_ptr == '-') {
-        expr_ptr++;  // skip '-'
-        return -parse_factor(error);  // unary minus
-        // Note 65 Flipping the sign after the recursive call maintains compatibility with expressions like -(-3), which should resolve to +3.
-    }
-    return parse_paren(error);
-}
-// Note 22 Handling unary minus here keeps the grammar simple: a factor can become negative without introducing separate tokens or precedence rules.
-
-// Parse terms: factors connected by * or / (or x).
-double parse_term(int* error) {
-    double left = parse_factor(error);
-    while (1) {
-        skip_spaces();
-        // Note 52 Because the parser is character-driven, skipping spaces inside the loop ensures operators like "x" or "/" are detected even when the user adds extra padding.
-        if (*expr_ptr == 'x' || *expr_ptr == 'X' || *expr_ptr == '*') {
-            double right = shift_parse(error);
-            left *= right;
-            // Note 66 Accepting both 'x' and '*' makes the calculator ergonomic on keyboards where typing '*' requires Shift, a thoughtful UX choice.
-        }
-        else if (*expr_ptr == '/') {
-            double right = shift_parse(error);
-            if (right == 0) {
+    double* temps = stack + prog->max_stack;
+
+    const ccal_insn* ip = prog->code;
+    const ccal_insn* end = ip + prog->code_len;
+    int sp = 0;
+    for (; ip < end; ip++) {
+        switch (ip->op) {
+        case CCAL_OP_CONST:
+            stack[sp++] = prog->consts[ip->arg];
+            break;
+        case CCAL_OP_NEG:
+            stack[sp - 1] = -stack[sp - 1];
+            break;
+        case CCAL_OP_ADD:
+            sp--;
+            stack[sp - 1] += stack[sp];
+            break;
+        case CCAL_OP_SUB:
+            sp--;
+            stack[sp - 1] -= stack[sp];
+            break;
+        case CCAL_OP_MUL:
+            sp--;
+            stack[sp - 1] *= stack[sp];
+            break;
+        case CCAL_OP_DIV:
+            sp--;
+            if (stack[sp] == 0) {
                 *error = 1;  // division by zero error
-                return 0;
+                break;
             }
-            left /= right;
-            // Note 67 Division falls back to floating-point, so even integer inputs can yield fractional results, reinforcing why formatting must adapt dynamically.
-        }
-        else if (*expr_ptr == 'p' || *expr_ptr == 'P' || *expr_ptr == '^') {
-            double right = shift_parse(error);
-            // power_of does not set to 1 or -1 when exponent is 0
-            if (left < 0)
-                left = right == 0 ? -1 : power_of(left, right);
-            else
-                left = right == 0 ? 1 : power_of(left, right);
-            // Note 68 Using integer exponents keeps evaluation predictable—raising a number to 2.5 would require a more sophisticated numeric library.
-        }
-        else {
+            stack[sp - 1] /= stack[sp];
+            break;
+        case CCAL_OP_POW:
+            sp--;
+            stack[sp - 1] = apply_power(stack[sp - 1], stack[sp], error);
+            break;
+        case CCAL_OP_COL:
+            *error = 1;  // no row to read, see ccal_exec_columns
+            break;
+        case CCAL_OP_STORE:
+            temps[ip->arg] = stack[sp - 1];
+            break;
+        case CCAL_OP_LOAD:
+            stack[sp++] = temps[ip->arg];
             break;
         }
+        if (*error)
+            break;
     }
-    return left;
+
+    double result = *error || sp != 1 ? 0 : stack[0];
+    if (sp != 1)
+        *error = 1;
+    if (stack != local)
+        free(stack);
+    return result;
 }
-// Note 23 This loop embodies operator precedence: by staying here until a non-term operator appears, multiplication, division, and exponentiation naturally bind tighter than addition or subtraction.
-// Note 24 The explicit division-by-zero check produces a clean parser error instead of relying on IEEE exceptions, which keeps feedback consistent across platforms.
-// Note 25 Exponentiation treats zero exponents as a special case to avoid raising 0^0, a helpful nod to discrete math rules that learners often encounter in coursework.
-
-// Parse expressions: terms connected by + or -.
-double parse_expr(int* error) {
-    double left = parse_term(error);
-    while (1) {
-        skip_spaces();
-        if (*expr_ptr == '+') {
-            expr_ptr++;
-            // Note 53 Incrementing expr_ptr consumes the operator so the recursive call sees the remainder of the expression without extra bookkeeping.
-            double right = parse_term(error);
-            left += right;
-        }
-        else if (*expr_ptr == '-') {
-            expr_ptr++;
-            // Note 54 The same pattern applies to subtraction, reinforcing that recursive descent can be implemented with minimal state.
-            double right = parse_term(error);
-            left -= right;
-        }
-        else {
-            if (*expr_ptr == '*' || *expr_ptr == 'x' || *expr_ptr == 'X' ||
-                *expr_ptr == '/' || *expr_ptr == 'p' || *expr_ptr == 'P' ||
-                *expr_ptr == '^') {
-                hasDec = 0;
-                maxDec = 0;
-                offDec = 1;
-                // Note 69 Encountering a high-precedence operator here usually means the user omitted an operand; flipping offDec ensures whatever happens next is shown without rounding assumptions.
+// Note 87 The interpreter loop never looks at the source text, so evaluating a formula repeatedly costs only the arithmetic plus one switch per instruction.
+// Note 106 Programs hold doubles, not the exact scaled integers the parser carries, so a compiled result can round differently from the same expression evaluated directly when it sits on a rounding boundary; README and --help say so for --columns.
+
+// Run a compiled program over rows of column data. cols[c] holds the values
+// of column c + 1 for each row and must exist for every column up to
+// prog->columns. Results go to out; err[i] is set to 1 where row i fails.
+// Returns 1 on success, 0 if the value stack cannot be allocated.
+int ccal_exec_columns(const ccal_program* prog, const double* const* cols,
+                      size_t rows, double* out, unsigned char* err) {
+    size_t slots = (size_t)prog->max_stack + prog->temp_count;
+    double* stack = malloc(slots * CCAL_EXEC_BLOCK * sizeof(double));
+    if (!stack)
+        return 0;
+    double* temps = stack + (size_t)prog->max_stack * CCAL_EXEC_BLOCK;
+
+    for (size_t base = 0; base < rows; base += CCAL_EXEC_BLOCK) {
+        size_t n = rows - base < CCAL_EXEC_BLOCK ? rows - base : CCAL_EXEC_BLOCK;
+        unsigned char* e = err + base;
+        memset(e, 0, n);
+
+        // each stack slot holds one value per row of the block
+        double* top = stack - CCAL_EXEC_BLOCK;
+        const ccal_insn* end = prog->code + prog->code_len;
+        for (const ccal_insn* ip = prog->code; ip < end; ip++) {
+            double* a = top - CCAL_EXEC_BLOCK;
+            size_t i;
+            switch (ip->op) {
+            case CCAL_OP_CONST:
+                top += CCAL_EXEC_BLOCK;
+                for (i = 0; i < n; i++)
+                    top[i] = prog->consts[ip->arg];
+                break;
+            case CCAL_OP_COL:
+                top += CCAL_EXEC_BLOCK;
+                memcpy(top, cols[ip->arg] + base, n * sizeof(double));
+                break;
+            case CCAL_OP_STORE:
+                memcpy(temps + (size_t)ip->arg * CCAL_EXEC_BLOCK, top, n * sizeof(double));
+                break;
+            case CCAL_OP_LOAD:
+                top += CCAL_EXEC_BLOCK;
+                memcpy(top, temps + (size_t)ip->arg * CCAL_EXEC_BLOCK, n * sizeof(double));
+                break;
+            case CCAL_OP_NEG:
+                for (i = 0; i < n; i++)
+                    top[i] = -top[i];
+                break;
+            case CCAL_OP_ADD:
+                for (i = 0; i < n; i++)
+                    a[i] += top[i];
+                top = a;
+                break;
+            case CCAL_OP_SUB:
+                for (i = 0; i < n; i++)
+                    a[i] -= top[i];
+                top = a;
+                break;
+            case CCAL_OP_MUL:
+                for (i = 0; i < n; i++)
+                    a[i] *= top[i];
+                top = a;
+                break;
+            case CCAL_OP_DIV:
+                for (i = 0; i < n; i++) {
+                    if (top[i] == 0) {
+                        e[i] = 1;  // division by zero error
+                        a[i] = 0;
+                    }
+                    else {
+                        a[i] /= top[i];
+                    }
+                }
+                top = a;
+                break;
+            case CCAL_OP_POW:
+                for (i = 0; i < n; i++) {
+                    int error = 0;
+                    a[i] = apply_power(a[i], top[i], &error);
+                    if (error) {
+                        e[i] = 1;
+                        a[i] = 0;
+                    }
+                }
+                top = a;
+                break;
             }
-            break;
         }
+        memcpy(out + base, stack, n * sizeof(double));
     }
-    return left;
-}
-// Note 26 By calling parse_term for both operands, this level implements left associativity—addition and subtraction are applied in the order encountered.
-// Note 27 The final branch toggles offDec when encountering higher-precedence symbols in unexpected positions, reinforcing that formatting should err on the side of precision if the grammar becomes ambiguous.
 
-// GUI APPLICATION - MAIN FUNCTION:
-//////////////////////////////////////////////////////////////////////////////
+    free(stack);
+    return 1;
+}
+// Note 91 Running each instruction across a whole block of rows pays the dispatch cost once per block instead of once per row, and leaves the compiler simple loops it can vectorize.
 
-// Evaluates an expression string and returns result. If error occurs,
-// *error is set to 1.
-double evaluate_expr_string(const char* expr, int* error) {
-    *error = 0;
-    expr_ptr = expr;  // initialize global pointer to start of expression
-    double result = parse_expr(error);
-    skip_spaces();
-    // Note 70 Trailing spaces are ignored so that copying expressions from text editors does not inadvertently trigger parse errors.
-    // if there are leftover characters after parsing, error
-    if (*expr_ptr != '\0') {
-        *error = 1;
-        return 0;
-    }
-    return result;
+// Release the memory held by a compiled program.
+void ccal_program_free(ccal_program* prog) {
+    free(prog->code);
+    free(prog->consts);
+    memset(prog, 0, sizeof(*prog));
 }
-// Note 28 Resetting expr_ptr at the entry point lets you reuse the same parsing machinery for both GUI input and command-line expressions without reinitializing global state elsewhere.
 
 /*****************************************************************************
 *  COMMAND LINE TOOL USEAGE:                                                 *
@@ -425,135 +2458,154 @@ double evaluate_expr_string(const char* expr, int* error) {
 //////////////////////////////////////////////////////////////////////////////
 // Note 59 Everything below adapts the core evaluator for argv-style inputs, showing how parsing logic can be shared across interfaces with thin wrappers.
 
-// Check if parameter passed is operator.
-int is_operator(const char* s) {
-    return (strcmp(s, "+") == 0 || strcmp(s, "-") == 0 ||
-            strcmp(s, "x") == 0 || strcmp(s, "X") == 0 ||
-            strcmp(s, "p") == 0 || strcmp(s, "P") == 0 ||
-            strcmp(s, "/") == 0);
-}
-// Note 29 Token-based evaluation uses string comparisons instead of characters so the same function can interpret user-provided argv segments verbatim.
-
-// Handle opening nest characters.
-int is_open_paren(const char* s) {
-    return (strcmp(s, "(") == 0 || strcmp(s, "[") == 0 || strcmp(s, "{") == 0);
-}
-// Note 30 Treating all bracket styles uniformly keeps the CLI behavior aligned with the GUI, making automated tests easier to write.
-
-// Handle closing nest characters.
-int is_close_paren(const char* s) {
-    return (strcmp(s, ")") == 0 || strcmp(s, "]") == 0 || strcmp(s, "}") == 0);
-}
-// Note 31 Having symmetric helpers for open and close delimiters avoids duplicating matching logic later in the stack.
-
-// Ensure nest characters match.
-int paren_match(const char* open, const char* close) {
-    return (strcmp(open, "(") == 0 && strcmp(close, ")") == 0) ||
-           (strcmp(open, "[") == 0 && strcmp(close, "]") == 0) ||
-           (strcmp(open, "{") == 0 && strcmp(close, "}") == 0);
-}
-// Note 32 Pairwise comparison makes the nesting check explicit; alternatives like mapping tables would add complexity without much benefit here.
-
 // Forward declaration.
-double parse_expr_eval(int* i, char* argv[], int argc, int* error);
-
-// Variation of parse_term for command line usage.
-double parse_term_eval(int* i, char* argv[], int argc, int* error) {
-    if (*i >= argc) {
-        *error = 1;
-        return 0;
+ccal_num parse_expr_eval(ccal_ctx* ctx, int* i, const ccal_token* toks, int count);
+
+// Variation of parse_term for command line usage, over the tokens
+// ccal_lex_argv read.
+ccal_num parse_term_eval(ccal_ctx* ctx, int* i, const ccal_token* toks, int count) {
+    CCAL_TRACE_HIT(CCAL_TRACE_TERM_EVAL);
+    if (*i >= count) {
+        ctx->error = 1;
+        return num_of(0);
     }
-    // Note 33 Here the parser walks argv[] manually, so bounds checking prevents reading past the provided command-line tokens.
+    // Note 33 Here the parser walks the tokens manually, so bounds checking prevents reading past the provided command-line arguments.
 
-    char* tok = argv[*i];
-    if (is_open_paren(tok)) {
-        const char* open = tok;
+    const ccal_token* tok = &toks[*i];
+    if (tok->kind == CCAL_TOK_OPEN) {
+        if (++ctx->nesting > ctx->max_depth) {
+            ctx->error = 1;
+            return num_of(0);
+        }
+        CCAL_TRACE_DEPTH(ctx->nesting);
         (*i)++;
-        double val = parse_expr_eval(i, argv, argc, error);
-        if (*error || *i >= argc      ||
-            !is_close_paren(argv[*i]) || !paren_match(open, argv[*i])) {
-            *error = 1;
-            return 0;
+        ccal_num val = parse_expr_eval(ctx, i, toks, count);
+        ctx->nesting--;
+        if (ctx->error || *i >= count  ||
+            toks[*i].kind != CCAL_TOK_CLOSE || toks[*i].op != tok->op) {
+            ctx->error = 1;
+            return num_of(0);
         }
         (*i)++;
         return val;
     }
-    else {
-        double val = atof(tok);
+    else if (tok->kind == CCAL_TOK_NUMBER) {
+        record_decimals(ctx, tok->decimals);
         (*i)++;
-        return val;
+        return tok->num;
+    }
+    else {
+        // an operator, a close bracket or an argument that is not a number
+        // where an operand is due
+        ctx->error = 1;
+        return num_of(0);
     }
 }
-// Note 71 atof tolerates leading plus/minus signs, allowing command-line users to write expressions like "-5 + 3" without extra syntax.
-// Note 34 Using atof here accepts the same formatting as strtod; additional validation happens at higher levels where operators are expected between numbers.
+// Note 31 An open token carries the character that must close it, so matching brackets is one comparison rather than a table of pairs.
+// Note 71 scan_number tolerates leading plus/minus signs, allowing command-line users to write expressions like "-5 + 3" without extra syntax.
+// Note 34 Using scan_number in the lexer accepts the same formatting as the quoted parser and reports where the number ended, so an argument with anything left over, like 5abc, or nothing numeric at all, like abc, is rejected instead of silently read as whatever prefix parsed.
 
 // Variation of parse_expr for command line useage.
-double parse_expr_eval(int* i, char* argv[], int argc, int* error) {
-    double result = parse_term_eval(i, argv, argc, error);
-    while (!*error && *i < argc) {
-        char* op = argv[*i];
-        if (!is_operator(op)) break;
+ccal_num parse_expr_eval(ccal_ctx* ctx, int* i, const ccal_token* toks, int count) {
+    CCAL_TRACE_HIT(CCAL_TRACE_EXPR_EVAL);
+    ccal_num result = parse_term_eval(ctx, i, toks, count);
+    while (!ctx->error && *i < count) {
+        int op = toks[*i].kind == CCAL_TOK_OP ? toks[*i].op : 0;
+        if (!op) break;
         (*i)++;
     // Note 72 Advancing the index before parsing the RHS mimics consuming a token from a stream, keeping the control flow consistent with pointer-based parsing.
-        double rhs = parse_term_eval(i, argv, argc, error);
+        ccal_num rhs = parse_term_eval(ctx, i, toks, count);
 
-        if (*error) return 0;
+        if (ctx->error) return num_of(0);
         // Note 81 Early exit keeps error propagation simple: once a subexpression fails, the caller immediately unwinds without mutating accumulated state.
 
-        if (strcmp(op, "*") == 0 || strcmp(op, "x") == 0 || strcmp(op, "X") == 0 ||
-            strcmp(op, "/") == 0 || strcmp(op, "p") == 0 || strcmp(op, "P") == 0) {
+        if (op == CCAL_OP_MUL || op == CCAL_OP_DIV || op == CCAL_OP_POW) {
             // set for decimal count
-            hasDec = 0;
-            maxDec = 0;
-            offDec = 1;
-        }
-        /* addition */
-        if (strcmp(op, "+") == 0) result += rhs;
-
-        /* subtraction */
-        else if (strcmp(op, "-") == 0) result -= rhs;
-
-        /* multiplication */
-        else if (strcmp(op, "x") == 0 || strcmp(op, "X") == 0 ||
-                 strcmp(op, "*") == 0) result *= rhs;
-
-        /* division */
-        else if (strcmp(op, "/") == 0) {
-            if (rhs == 0) {
-                *error = 1;
-                return 0;
-            }
-            result /= rhs;
-        }
-        else if (strcmp(op, "p") == 0 || strcmp(op, "P") == 0) {
-            if (result < 0)
-                result = rhs == 0 ? -1 : power_of(result, rhs);
-            else
-                result = rhs == 0 ? 1 : power_of(result, rhs);
+            ctx->hasDec = 0;
+            ctx->maxDec = 0;
+            ctx->offDec = 1;
         }
+        apply_binary(ctx, op, &result, &rhs);
     }
-    return result;
+    return ctx->error ? num_of(0) : result;
 }
-// Note 49 Even though the operators are expressed as strings, the arithmetic remains straightforward; this demonstrates how lexical concerns can be kept separate from evaluation logic.
+// Note 32 Operators apply strictly left to right here, as they always have on the command line, but through the same apply_binary as the quoted parser, so division by zero and powers with no real result are caught identically.
+// Note 49 Lexing the arguments once up front keeps lexical concerns apart from evaluation: the loop above never looks at a character.
 // Note 35 Parsing command-line tokens mirrors the recursive-descent structure with indexes instead of pointers, highlighting how grammar logic can be reused across input modalities.
 // Note 36 offDec is toggled when high-precision operations appear, ensuring the formatting logic later honors potential fractional outputs even if prior operands looked like integers.
 
-// Internal token-array based evaluator.
-double evaluate(int argc, char* argv[], int* error) {
-    *error = 0;
-    if (argc < 1) {
-        *error = 1;
-        return 0;
+// Arguments lexed into the evaluator's frame; longer commands use the heap.
+#define ARGV_TOKENS_LOCAL 32
+
+// Token array of at least count entries kept by the context, or NULL if
+// memory runs out.
+static ccal_token* argv_tokens(ccal_ctx* ctx, int count) {
+    if (count > ctx->token_cap) {
+        ccal_token* tokens = realloc(ctx->tokens, (size_t)count * sizeof(ccal_token));
+        if (!tokens)
+            return NULL;
+        ctx->tokens = tokens;
+        ctx->token_cap = count;
     }
-    // Note 37 The CLI requires at least one operand; empty input is flagged early so the user sees a clear error message instead of undefined behavior later.
+    return ctx->tokens;
+}
 
+// Token-array based evaluator returning a number whose double is settled to
+// its exact value when there is one.
+static ccal_num evaluate_tokens_num(ccal_ctx* ctx, int argc, char* argv[], int* error) {
+    CCAL_PROBE1(expr__start, argc);
+    CCAL_PROBE_CLOCK(probe_start, expr__end);
+    ctx->error = 0;
+    ctx->nesting = 0;
+    ccal_num result = num_of(0);
     int index = 0;
-    double result = parse_expr_eval(&index, argv, argc, error);
+    ccal_token local[ARGV_TOKENS_LOCAL];
+    ccal_token* toks = argc > ARGV_TOKENS_LOCAL ? argv_tokens(ctx, argc) : local;
+    if (argc < 1 || !toks)
+        ctx->error = 1;
+    // Note 37 The CLI requires at least one operand; empty input is flagged early so the user sees a clear error message instead of undefined behavior later.
+    else {
+        ccal_lex_argv(argc, argv, toks);
+        result = parse_expr_eval(ctx, &index, toks, argc);
+    }
 
-    if (index != argc) {
-        *error = 1;
-        return 0;
+    if (index != argc)
+        ctx->error = 1;
+    *error = ctx->error;
+    if (ctx->error) {
+        CCAL_PROBE2(parse__error, argc, index);
+        result = num_of(0);
     }
+    else
+        num_settle(&result);
+    CCAL_PROBE4(expr__end, argc, ccal_probe_bits(result.value), ctx->error,
+                CCAL_PROBE_ELAPSED(probe_start));
+    return result;
+}
+
+// Internal token-array based evaluator.
+double ccal_evaluate_tokens(ccal_ctx* ctx, int argc, char* argv[], int* error) {
+    return evaluate_tokens_num(ctx, argc, argv, error).value;
+}
+
+// Token-array based evaluator returning the value together with the
+// precision of its operands. If error occurs, *error is set to 1.
+ccal_result ccal_evaluate_tokens_result(ccal_ctx* ctx, int argc, char* argv[], int* error) {
+    ctx->hasDec = 0;
+    ctx->maxDec = 0;
+    ctx->offDec = 0;
+    ccal_num num = evaluate_tokens_num(ctx, argc, argv, error);
+    ccal_result res = { num.value, ctx->hasDec, ctx->maxDec, ctx->offDec,
+                        num.mant, num.scale, num.exact };
+    return res;
+}
+// Note 44 Because offDec is part of the record, a product or quotient typed as tokens keeps its full precision exactly as it did when the tokens were rejoined and scanned.
+
+// Token-array based evaluator using the default context.
+double evaluate(int argc, char* argv[], int* error) {
+    load_default_ctx();
+    double result = ccal_evaluate_tokens(&default_ctx, argc, argv, error);
+    store_default_ctx();
     return result;
 }
 // Note 74 Returning the accumulated result rather than modifying a global variable keeps the function reentrant—two evaluations in a row won't interfere with each other.
@@ -564,8 +2616,29 @@ double evaluate(int argc, char* argv[], int* error) {
 
 // If not compiling GUI with:
 // gcc -DBUILDING_GUI ccal.c ccal_gui.c -o ccal_gui.exe -mwindows
-#ifndef BUILDING_GUI
+// or the library with build_lib.sh
+#if !defined(BUILDING_GUI) && !defined(CCAL_LIBRARY)
+#ifdef CCAL_TRACE
+// Print the trace counters when ccal exits, whichever mode ran.
+static void print_trace_stats(void) {
+    ccal_trace_print(stderr);
+}
+#endif
+
 int main(int argc, char* argv[]) {
+    // Check for trace flag: print the hot-path counters on exit
+    if (argc > 1 && strcmp(argv[1], "--trace-stats") == 0) {
+        #ifdef CCAL_TRACE
+        atexit(print_trace_stats);
+        argv[1] = argv[0];
+        argv++;
+        argc--;
+        #else
+        fprintf(stderr, "Error: --trace-stats needs ccal built with -DCCAL_TRACE\n");
+        return 1;
+        #endif
+    }
+
     if (argc == 1 ||
        (argc == 2 && (strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0))
        )
@@ -576,6 +2649,93 @@ int main(int argc, char* argv[]) {
     }
     // Note 39 The CLI mirrors Unix conventions: no arguments or --help prints documentation, making the tool friendly for shell usage and automated scripts.
 
+    // Check for batch flag: evaluate one expression per line
+    if (strcmp(argv[1], "-b") == 0 || strcmp(argv[1], "--batch") == 0) {
+        BatchOptions opts = { "-", 1, 0, 0, 0 };
+        int have_path = 0;
+        int have_cache = 0;
+        for (int i = 2; i < argc; i++) {
+            if ((strcmp(argv[i], "-t") == 0 || strcmp(argv[i], "--threads") == 0) &&
+                i + 1 < argc) {
+                char* end;
+                long n = strtol(argv[++i], &end, 10);
+                if (*end != '\0' || n < 0) {
+                    fprintf(stderr, "Error: Invalid thread count '%s'\n", argv[i]);
+                    return 1;
+                }
+                opts.threads = (int)n;
+            }
+            else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+                char* end;
+                long kib = strtol(argv[++i], &end, 10);
+                if (*end != '\0' || kib < 0 || kib > (LONG_MAX >> 10)) {
+                    fprintf(stderr, "Error: Invalid cache size '%s'\n", argv[i]);
+                    return 1;
+                }
+                opts.cache = (size_t)kib << 10;
+                have_cache = 1;
+            }
+            else if (strcmp(argv[i], "--cache-stats") == 0) {
+                opts.cache_stats = 1;
+            }
+            else if (strcmp(argv[i], "--latency") == 0) {
+                opts.latency = 1;
+                // Note 102 Latency histograms are kept per thread and only merged when printed, so recording a sample is a clock read and a counter increment with no lock; percentiles, not the mean, show the occasional slow line that a stream of fast ones hides.
+            }
+            else if (!have_path) {
+                opts.path = argv[i];
+                have_path = 1;
+            }
+            else {
+                fprintf(stderr, "Usage: ccal [-b|--batch] [-t|--threads N] [--cache KiB] "
+                                "[--cache-stats] [--latency] [file|-]\n");
+                return 1;
+            }
+        }
+        if (opts.cache_stats && !have_cache)
+            opts.cache = (size_t)BATCH_CACHE_DEFAULT_KIB << 10;
+        return run_batch(&opts);
+    }
+    // Note 88 Batch mode reuses one process, one context and one line buffer for every expression, so a pipeline pays the startup cost once rather than per calculation.
+    // Check for columns flag: evaluate one expression over every CSV row
+    if (strcmp(argv[1], "-c") == 0 || strcmp(argv[1], "--columns") == 0) {
+        if (argc < 3 || argc > 4) {
+            fprintf(stderr, "Usage: ccal [-c|--columns] <expression> [file|-]\n");
+            return 1;
+        }
+        ColumnsOptions opts = { argv[2], argc == 4 ? argv[3] : "-" };
+        return run_columns(&opts);
+    }
+    // Check for serve flag: answer requests on a Unix domain socket
+    if (strcmp(argv[1], "--serve") == 0) {
+        int latency = argc == 4 && strcmp(argv[3], "--latency") == 0;
+        if (argc != 3 && !latency) {
+            fprintf(stderr, "Usage: ccal --serve <socket> [--latency]\n");
+            return 1;
+        }
+        ServeOptions opts = { argv[2], latency };
+        return run_serve(&opts);
+    }
+    // Note 99 A server keeps the process, its evaluator context and any conversion rules it loaded alive between requests, so a client pays for a connection once instead of an exec, dynamic linking and rule parsing per calculation.
+    // Check for shm flag: answer requests from a shared-memory segment
+    if (strcmp(argv[1], "--shm") == 0) {
+        if (argc != 3) {
+            fprintf(stderr, "Usage: ccal --shm <name>\n");
+            return 1;
+        }
+        ShmOptions opts = { argv[2] };
+        return run_shm(&opts);
+    }
+    // Check for repl flag: evaluate lines typed at a prompt in one process
+    if (strcmp(argv[1], "--repl") == 0) {
+        if (argc != 2) {
+            fprintf(stderr, "Usage: ccal --repl\n");
+            return 1;
+        }
+        return run_repl();
+    }
+    // Note 100 The REPL keeps the same state for a person at a prompt; a line starting with an operator continues from the previous result, as the GUI does when an operator follows "=".
+
     // Check for module flag: /M, -m, or --module
     if ((strcmp(argv[1], "/M") == 0 || strcmp(argv[1], "-m") == 0 || strcmp(argv[1], "--module") == 0)) {
         if (argc < 6) {
@@ -674,14 +2834,11 @@ int main(int argc, char* argv[]) {
         return 0;
     }
 
+    ccal_ctx ctx;
+    ccal_result res;
     int error;
-    int fatalError = 0;
-    double result;
-    char* expressionForFormat = NULL;
-    int expressionNeedsFree = 0;
-    // Note 47 fatalError distinguishes allocation failures from syntax errors so we can exit with a non-zero status without printing misleading parser diagnostics.
+    // Note 40 Both input styles produce the same result record, so the formatting code below never needs to know whether the expression was quoted or tokenized.
 
-    // Note 40 These variables buffer the cleaned expression so that formatting decisions later can treat tokenized and quoted inputs uniformly.
     // check if quoted option passed
     if (strcmp(argv[1], "-q") == 0 || strcmp(argv[1], "--quote") == 0) {
         if (argc < 3) {
@@ -690,27 +2847,13 @@ int main(int argc, char* argv[]) {
         }
         // Note 83 Quoted mode lets users supply spaces or traditional '*' and '^' characters without shell tokenization breaking the expression apart.
 
-        // duplicate and clean expression
-        char* expr = strdup(argv[2]);
-        if (!expr) {
-            fprintf(stderr, "Memory error\n");
-            return 1;
-        }
-        // Note 41 Duplicating the string keeps the original argv untouched, which is important when other code might inspect it after evaluation.
-        hasDec = 0;
-        maxDec = 0;
-        offDec = 0;
-        remove_format(expr);
-    // Note 55 Removing commas and currency symbols mirrors GUI behavior, so command-line usage can accept pasted spreadsheet values without surprises.
-        result = evaluate_expr_string(expr, &error);
-        if (!error) {
-            expressionForFormat = expr;
-            expressionNeedsFree = 1;
-        } else {
-            free(expr);
-        }
+        ccal_ctx_init(&ctx);
+        res = ccal_evaluate_result(&ctx, argv[2], strlen(argv[2]), &error);
+        // Note 41 The span parser never writes to its input, so argv[2] is evaluated where it lies instead of being duplicated first.
+    // Note 55 Commas and currency symbols are stepped over by the parser itself, mirroring GUI behavior, so command-line usage can accept pasted spreadsheet values without surprises.
     } else {
         // regular token-based input
+        ccal_ctx_init(&ctx);
         char** cleaned_args = malloc((argc - 1) * sizeof(char*));
         if (!cleaned_args) {
             fprintf(stderr, "Memory error\n");
@@ -718,60 +2861,29 @@ int main(int argc, char* argv[]) {
         }
         // Note 42 Allocating a new argv array allows the tool to strip commas and currency symbols without mutating the real argv passed by the OS.
 
-        size_t exprLen = 0;
         for (int i = 0; i < argc - 1; ++i) {
             cleaned_args[i] = strdup(argv[i + 1]);
             if (!cleaned_args[i]) {
                 fprintf(stderr, "Memory error\n");
                 return 1;
             }
-            remove_format(cleaned_args[i]);
-            exprLen += strlen(cleaned_args[i]);
+            ccal_remove_format(&ctx, cleaned_args[i]);
             // Note 56 Each token is sanitized independently, enabling expressions like "1,000 - 200" where only some inputs carry separators.
         }
-        // Note 43 The loop both cleans and measures the expression, collecting enough information to rebuild a human-readable string later.
-
-        hasDec = 0;
-        maxDec = 0;
-        offDec = 0;
-        result = evaluate(argc - 1, cleaned_args, &error);
 
-        if (!error) {
-            size_t bufferSize = exprLen + (argc - 2) + 1; // spaces between tokens
-            expressionForFormat = malloc(bufferSize);
-            if (!expressionForFormat) {
-                fprintf(stderr, "Memory error\n");
-                error = 1;
-                fatalError = 1;
-            } else {
-                // Note 82 The buffer leaves room for spaces between tokens plus the null terminator, mirroring how join operations work in higher-level languages.
-                size_t pos = 0;
-                for (int i = 0; i < argc - 1; ++i) {
-                    size_t tokLen = strlen(cleaned_args[i]);
-                    memcpy(expressionForFormat + pos, cleaned_args[i], tokLen);
-                    pos += tokLen;
-                    if (i + 1 < argc - 1)
-                        expressionForFormat[pos++] = ' ';
-                    // Note 57 Rebuilding the string with explicit spaces keeps the final formatting predictable regardless of the spacing in the original command line.
-                }
-                expressionForFormat[pos] = '\0';
-                expressionNeedsFree = 1;
-            }
-        }
-        // Note 44 Reassembling the cleaned tokens into a single string provides the same formatting context that quoted mode enjoys, keeping output consistent.
+        res = ccal_evaluate_tokens_result(&ctx, argc - 1, cleaned_args, &error);
+        // Note 43 Decimal places are counted as each token is converted, so the tokens never have to be joined back into a string just to be scanned again.
 
         for (int i = 0; i < argc - 1; ++i) {
             free(cleaned_args[i]);
         }
 
         free(cleaned_args);
+        // Note 48 Manual memory management is unavoidable in portable C; each duplicated token is released before the array that holds it.
     }
+    ccal_ctx_free(&ctx);
 
     if (error) {
-        if (expressionNeedsFree)
-            free(expressionForFormat);
-        if (fatalError)
-            return 1;
         printf("Error: Invalid expression\n");
         // Note 58 Reporting parse errors on stdout matches the historical behavior of many calculators, but returning non-zero still allows shell scripts to detect failures.
         return 1;
@@ -779,20 +2891,12 @@ int main(int argc, char* argv[]) {
     // Note 45 From here on we know evaluation succeeded, so the emphasis shifts to presenting the answer with the correct precision.
 
     char formatted[64];
-    if (!expressionForFormat) {
-        snprintf(formatted, sizeof(formatted), "%.16g", result);
-    } else {
-        FormatOutput(expressionForFormat, result, formatted);
-    }
-    // Note 46 Falling back to %.16g ensures we still return a value if formatting context was unavailable, such as after memory-allocation failures.
+    ccal_format_result(&res, formatted);
+    // Note 46 The record already carries the precision gathered during the parse, so formatting is one pass over the result's digits no matter how long the expression was.
 
     printf("%s\n", formatted);
     // Note 73 Printing the result with a trailing newline lets users pipe the output into other shell commands without additional formatting.
 
-    if (expressionNeedsFree)
-        free(expressionForFormat);
-    // Note 48 Manual memory management is unavoidable in portable C; freeing only when the pointer was allocated prevents double-free bugs while keeping success path fast.
-
     return 0;
 }
 #endif
@@ -0,0 +1,227 @@
+// ccal.h
+// Reentrant interface to the ccal expression evaluator.
+// Every parser routine works on a ccal_ctx instead of file-scope globals, so
+// separate contexts can evaluate expressions on separate threads at once.
+
+#ifndef CCAL_H
+#define CCAL_H
+
+#include <stddef.h>
+
+// Functions exported by the libccal shared library (see build_lib.sh); the
+// library is compiled with hidden visibility so nothing else leaks out.
+#if defined(_WIN32) && defined(CCAL_LIBRARY)
+#define CCAL_API __declspec(dllexport)
+#elif defined(__GNUC__)
+#define CCAL_API __attribute__((visibility("default")))
+#else
+#define CCAL_API
+#endif
+
+// Bytecode operations emitted by ccal_compile.
+enum {
+    CCAL_OP_CONST,  // push consts[arg]
+    CCAL_OP_NEG,    // negate top of stack
+    CCAL_OP_ADD,    // pop two values, push sum
+    CCAL_OP_SUB,    // pop two values, push difference
+    CCAL_OP_MUL,    // pop two values, push product
+    CCAL_OP_DIV,    // pop two values, push quotient (error on zero divisor)
+    CCAL_OP_POW,    // pop two values, push power
+    CCAL_OP_COL,    // push column arg of the current row ($N is arg N - 1)
+    CCAL_OP_STORE,  // copy top of stack to temporary arg, leaving it in place
+    CCAL_OP_LOAD    // push temporary arg
+};
+
+// Highest column a $N placeholder may name.
+#define CCAL_MAX_COLUMNS 1024
+
+// Default nesting limit of brackets and unary minus for a context.
+#define CCAL_MAX_DEPTH 10000
+
+// Rows ccal_exec_columns evaluates per pass over the program.
+#define CCAL_EXEC_BLOCK 256
+
+// Flags for ccal_write_result.
+#define CCAL_FORMAT_GROUP 1  // separate thousands with ',' like the GUI input
+
+// Buffer size ccal_write_result needs with CCAL_FORMAT_GROUP.
+#define CCAL_RESULT_MAX 96
+
+// Single bytecode instruction.
+typedef struct {
+    int op;   // CCAL_OP_* code
+    int arg;  // operand (constant pool index for CCAL_OP_CONST)
+} ccal_insn;
+
+// Compiled expression: postfix instructions plus constant pool. ccal_compile
+// folds constant subexpressions and computes repeated ones only once.
+typedef struct {
+    ccal_insn* code;   // instruction stream
+    int code_len;      // number of instructions
+    int code_cap;      // allocated instructions
+    double* consts;    // constant pool
+    int const_count;   // number of constants
+    int const_cap;     // allocated constants
+    int max_stack;     // deepest value stack needed by ccal_exec
+    int columns;       // highest $N placeholder referenced, 0 if none
+    int temp_count;    // temporaries holding shared subexpressions
+    int hasDec;        // precision state recorded while compiling
+    int maxDec;
+    int offDec;
+} ccal_program;
+
+// Number carried through an evaluation. While every operation so far was
+// exact, mant / 10^scale is the value with no rounding at all.
+typedef struct {
+    double value;    // value as a double, always set
+    long long mant;  // scaled integer, valid when exact is 1
+    int scale;       // decimal places of mant, 0 to CCAL_EXACT_SCALE
+    int exact;       // 1 while mant / 10^scale holds the value exactly
+} ccal_num;
+
+// Most decimal places an exact value keeps before falling back to double.
+#define CCAL_EXACT_SCALE 18
+
+// Value of an evaluation plus the precision gathered while parsing it, so
+// formatting never has to read the expression again.
+typedef struct {
+    double value;    // computed result
+    int hasDec;      // an operand had a decimal point
+    int maxDec;      // most meaningful decimals among the operands
+    int offDec;      // 1 turns decimal formatting off
+    long long mant;  // exact result as mant / 10^scale when exact is 1
+    int scale;       // decimal places of mant
+    int exact;       // 1 when mant and scale hold the result exactly
+} ccal_result;
+
+// Kinds of token ccal_next_token and ccal_lex_argv read.
+enum {
+    CCAL_TOK_END,     // nothing but spaces and formatting left
+    CCAL_TOK_NUMBER,  // number; num and decimals hold its value
+    CCAL_TOK_OP,      // binary operator; op holds its CCAL_OP_* code
+    CCAL_TOK_NEG,     // unary minus
+    CCAL_TOK_OPEN,    // open bracket; op holds the character closing it
+    CCAL_TOK_CLOSE,   // close bracket; op holds the character
+    CCAL_TOK_BAD      // one character the parser rejects in this position, or
+                      // an argument ccal_lex_argv cannot read as a whole
+};
+
+// Token of an expression, as the parser reads it.
+typedef struct {
+    int kind;         // CCAL_TOK_* code
+    int op;           // operator code or bracket character, see above
+    size_t start;     // offset of the token in the expression (0 from ccal_lex_argv)
+    size_t len;       // bytes of the token
+    ccal_num num;     // value of a CCAL_TOK_NUMBER
+    int decimals;     // its meaningful decimals, -1 without a decimal point
+    size_t look;      // end of the text reading it examined, one past the last
+                      // character that could have changed it (start + len from
+                      // ccal_lex_argv)
+} ccal_token;
+
+// Evaluator state: parse cursor, decimal precision and error flag.
+typedef struct {
+    const char* expr_ptr;  // current position in expression string
+    const char* expr_end;  // end of the expression span
+    int hasDec;            // don't round if no decimal
+    int maxDec;            // maximum number of meaningful decimals
+    int offDec;            // if 1 turn off decimal formatting always
+    int error;             // set to 1 when the expression is invalid
+    ccal_program* prog;    // when set the parser emits bytecode here
+    int depth;             // value stack depth while emitting
+    int columns;           // when set, $N is a column placeholder, not formatting
+    int max_depth;         // deepest nesting of brackets and unary minus allowed
+    int nesting;           // brackets open while evaluating tokens
+    ccal_num* values;      // heap operand stack for deep expressions, kept
+    int* ops;              // heap operator stack, kept, see ccal_ctx_free
+    int stack_cap;         // entries allocated on each heap stack
+    ccal_token* tokens;    // heap argv tokens for long commands, kept
+    int token_cap;         // entries allocated on tokens
+    const ccal_result* ans;  // value the word "ans" stands for, NULL if none
+} ccal_ctx;
+
+// Longest canonical expression a result cache stores; longer ones bypass it.
+#define CCAL_CACHE_KEY_MAX 64
+
+// One remembered evaluation of a ccal_cache.
+typedef struct {
+    unsigned long long hash;        // hash of key
+    int next;                       // next entry in the same bucket, -1 at the end
+    unsigned char key_len;          // bytes of key
+    unsigned char ref;              // CLOCK reference bit, set on every hit
+    unsigned char error;            // the expression was invalid
+    ccal_result res;                // value and precision as evaluated
+    char key[CCAL_CACHE_KEY_MAX];   // canonical expression text
+} ccal_cache_entry;
+
+// Results of earlier evaluations keyed by canonical expression text. Memory
+// is fixed when the cache is created and old entries are evicted by CLOCK.
+typedef struct {
+    ccal_cache_entry* entries;      // slots swept by the CLOCK hand
+    int* buckets;                   // first entry of each hash chain, -1 if empty
+    int capacity;                   // slots, 0 while the cache is off
+    int bucket_mask;                // hash bits selecting a bucket
+    int used;                       // slots filled so far
+    int hand;                       // next slot the CLOCK hand inspects
+    unsigned long long hits;        // evaluations answered from the cache
+    unsigned long long misses;      // evaluations that ran the parser
+    unsigned long long evictions;   // entries replaced to make room
+} ccal_cache;
+
+// Context functions.
+CCAL_API void ccal_ctx_init(ccal_ctx* ctx);
+CCAL_API void ccal_ctx_free(ccal_ctx* ctx);
+CCAL_API void ccal_remove_format(ccal_ctx* ctx, char* str);
+CCAL_API double ccal_evaluate(ccal_ctx* ctx, const char* expr, int* error);
+CCAL_API double ccal_evaluate_span(ccal_ctx* ctx, const char* expr, size_t len, int* error);
+CCAL_API double ccal_parse_number(ccal_ctx* ctx, const char* str, size_t len, int* error);
+CCAL_API double ccal_evaluate_tokens(ccal_ctx* ctx, int argc, char* argv[], int* error);
+CCAL_API ccal_result ccal_evaluate_result(ccal_ctx* ctx, const char* expr, size_t len, int* error);
+CCAL_API ccal_result ccal_evaluate_tokens_result(ccal_ctx* ctx, int argc, char* argv[], int* error);
+CCAL_API void ccal_format_result(const ccal_result* res, char* fin_str);
+CCAL_API size_t ccal_write_result(const ccal_result* res, int flags, char* fin_str);
+CCAL_API void ccal_format_output(ccal_ctx* ctx, const char* expr, double result, char* fin_str);
+CCAL_API void ccal_format_output_span(ccal_ctx* ctx, const char* expr, size_t len,
+                                      double result, char* fin_str);
+
+// Token functions, for evaluators that keep their own parse state.
+CCAL_API size_t ccal_next_token(const char* expr, size_t len, size_t pos, int operand,
+                                ccal_token* tok);
+CCAL_API void ccal_lex_argv(int argc, char* argv[], ccal_token* toks);
+CCAL_API int ccal_apply(int op, ccal_num* left, const ccal_num* right);
+CCAL_API void ccal_settle(ccal_num* num);
+
+// Result cache functions.
+CCAL_API int ccal_cache_init(ccal_cache* cache, size_t max_bytes);
+CCAL_API void ccal_cache_free(ccal_cache* cache);
+CCAL_API ccal_result ccal_cache_evaluate(ccal_cache* cache, ccal_ctx* ctx, const char* expr,
+                                         size_t len, int* error);
+
+// Compiled expression functions.
+CCAL_API int ccal_compile(ccal_ctx* ctx, const char* expr, ccal_program* prog);
+CCAL_API double ccal_exec(const ccal_program* prog, int* error);
+CCAL_API int ccal_exec_columns(const ccal_program* prog, const double* const* cols,
+                               size_t rows, double* out, unsigned char* err);
+CCAL_API void ccal_program_free(ccal_program* prog);
+
+// Unit conversion rules of the converter module, loaded by ccal_rules_load.
+typedef struct ccal_rules ccal_rules;
+
+// Status codes of ccal_convert.
+enum {
+    CCAL_CONVERT_OK,            // result holds the converted value
+    CCAL_CONVERT_UNKNOWN_FROM,  // source unit is not in the rule set
+    CCAL_CONVERT_UNKNOWN_TO,    // target unit is not in the rule set
+    CCAL_CONVERT_UNDEFINED      // the rule set has no factor for the pair
+};
+
+// Unit conversion functions (modules/converter.c).
+CCAL_API ccal_rules* ccal_rules_load(const char* name);
+CCAL_API ccal_rules* ccal_rules_load_file(const char* path);
+CCAL_API const char* ccal_rules_detect(const char* from_unit, const char* to_unit);
+CCAL_API void ccal_rules_free(ccal_rules* rules);
+CCAL_API int ccal_convert(const ccal_rules* rules, double value, const char* from_unit,
+                          const char* to_unit, double* result);
+CCAL_API int ccal_unit_short_name(const ccal_rules* rules, const char* unit, char* buf, size_t cap);
+
+#endif // CCAL_H
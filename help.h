@@ -7,97 +7,299 @@ unsigned char help_txt[] = {
   0x6d, 0x61, 0x74, 0x68, 0x65, 0x6d, 0x61, 0x74, 0x69, 0x63, 0x61, 0x6c,
   0x20, 0x65, 0x78, 0x70, 0x72, 0x65, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x73,
   0x2e, 0x0d, 0x0a, 0x0d, 0x0a, 0x20, 0x55, 0x73, 0x61, 0x67, 0x65, 0x3a,
-  0x20, 0x63, 0x63, 0x61, 0x6c, 0x20, 0x5b, 0x2d, 0x68, 0x2c, 0x20, 0x2d,
-  0x2d, 0x68, 0x65, 0x6c, 0x70, 0x5d, 0x20, 0x5b, 0x2d, 0x71, 0x2c, 0x20,
-  0x2d, 0x2d, 0x71, 0x75, 0x6f, 0x74, 0x65, 0x20, 0x3c, 0x65, 0x78, 0x70,
-  0x72, 0x65, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x3e, 0x5d, 0x20, 0x7c, 0x20,
+  0x20, 0x63, 0x63, 0x61, 0x6c, 0x20, 0x5b, 0x2d, 0x2d, 0x74, 0x72, 0x61,
+  0x63, 0x65, 0x2d, 0x73, 0x74, 0x61, 0x74, 0x73, 0x5d, 0x20, 0x5b, 0x2d,
+  0x68, 0x2c, 0x20, 0x2d, 0x2d, 0x68, 0x65, 0x6c, 0x70, 0x5d, 0x20, 0x5b,
+  0x2d, 0x71, 0x2c, 0x20, 0x2d, 0x2d, 0x71, 0x75, 0x6f, 0x74, 0x65, 0x20,
   0x3c, 0x65, 0x78, 0x70, 0x72, 0x65, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x3e,
-  0x0d, 0x0a, 0x0d, 0x0a, 0x20, 0x4f, 0x70, 0x74, 0x69, 0x6f, 0x6e, 0x20,
-  0x4c, 0x69, 0x73, 0x74, 0x3a, 0x0d, 0x0a, 0x0d, 0x0a, 0x20, 0x4f, 0x70,
-  0x74, 0x69, 0x6f, 0x6e, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
-  0x20, 0x20, 0x20, 0x20, 0x44, 0x65, 0x73, 0x63, 0x72, 0x69, 0x70, 0x74,
-  0x69, 0x6f, 0x6e, 0x0d, 0x0a, 0x20, 0x20, 0x2d, 0x68, 0x2c, 0x20, 0x2d,
-  0x2d, 0x68, 0x65, 0x6c, 0x70, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
-  0x20, 0x4f, 0x75, 0x74, 0x70, 0x75, 0x74, 0x20, 0x74, 0x68, 0x65, 0x20,
-  0x63, 0x6f, 0x6e, 0x74, 0x65, 0x6e, 0x74, 0x73, 0x20, 0x6f, 0x66, 0x20,
-  0x74, 0x68, 0x65, 0x20, 0x68, 0x65, 0x6c, 0x70, 0x20, 0x28, 0x74, 0x68,
-  0x69, 0x73, 0x29, 0x20, 0x64, 0x6f, 0x63, 0x75, 0x6d, 0x65, 0x6e, 0x74,
-  0x2e, 0x0d, 0x0a, 0x20, 0x20, 0x2d, 0x71, 0x2c, 0x20, 0x2d, 0x2d, 0x71,
-  0x75, 0x6f, 0x74, 0x65, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x55,
-  0x73, 0x65, 0x20, 0x71, 0x75, 0x6f, 0x74, 0x65, 0x73, 0x20, 0x66, 0x6f,
-  0x72, 0x20, 0x74, 0x68, 0x65, 0x20, 0x6d, 0x61, 0x74, 0x68, 0x65, 0x6d,
-  0x61, 0x74, 0x69, 0x63, 0x61, 0x6c, 0x20, 0x65, 0x78, 0x70, 0x72, 0x65,
-  0x73, 0x73, 0x69, 0x6f, 0x6e, 0x2e, 0x0d, 0x0a, 0x20, 0x20, 0x65, 0x78,
-  0x70, 0x72, 0x65, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x20, 0x20, 0x20, 0x20,
-  0x20, 0x20, 0x20, 0x20, 0x54, 0x68, 0x65, 0x20, 0x6d, 0x61, 0x74, 0x68,
-  0x65, 0x6d, 0x61, 0x74, 0x69, 0x63, 0x61, 0x6c, 0x20, 0x65, 0x78, 0x70,
-  0x72, 0x65, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x20, 0x74, 0x6f, 0x20, 0x63,
-  0x61, 0x6c, 0x63, 0x75, 0x6c, 0x61, 0x74, 0x65, 0x2e, 0x0d, 0x0a, 0x20,
-  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
-  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x49, 0x4d, 0x50, 0x4f, 0x52,
-  0x54, 0x41, 0x4e, 0x54, 0x20, 0x2d, 0x20, 0x77, 0x68, 0x65, 0x6e, 0x20,
-  0x75, 0x73, 0x65, 0x64, 0x20, 0x77, 0x69, 0x74, 0x68, 0x6f, 0x75, 0x74,
+  0x5d, 0x20, 0x7c, 0x20, 0x3c, 0x65, 0x78, 0x70, 0x72, 0x65, 0x73, 0x73,
+  0x69, 0x6f, 0x6e, 0x3e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x63, 0x63, 0x61, 0x6c, 0x20, 0x5b, 0x2d, 0x62, 0x2c, 0x20,
+  0x2d, 0x2d, 0x62, 0x61, 0x74, 0x63, 0x68, 0x5d, 0x20, 0x5b, 0x2d, 0x74,
+  0x2c, 0x20, 0x2d, 0x2d, 0x74, 0x68, 0x72, 0x65, 0x61, 0x64, 0x73, 0x20,
+  0x3c, 0x6e, 0x3e, 0x5d, 0x20, 0x5b, 0x2d, 0x2d, 0x63, 0x61, 0x63, 0x68,
+  0x65, 0x20, 0x3c, 0x4b, 0x69, 0x42, 0x3e, 0x5d, 0x20, 0x5b, 0x2d, 0x2d,
+  0x63, 0x61, 0x63, 0x68, 0x65, 0x2d, 0x73, 0x74, 0x61, 0x74, 0x73, 0x5d,
+  0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x5b, 0x2d, 0x2d, 0x6c, 0x61, 0x74, 0x65, 0x6e, 0x63,
+  0x79, 0x5d, 0x20, 0x5b, 0x66, 0x69, 0x6c, 0x65, 0x20, 0x7c, 0x20, 0x2d,
+  0x5d, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x63,
+  0x63, 0x61, 0x6c, 0x20, 0x5b, 0x2d, 0x63, 0x2c, 0x20, 0x2d, 0x2d, 0x63,
+  0x6f, 0x6c, 0x75, 0x6d, 0x6e, 0x73, 0x20, 0x3c, 0x65, 0x78, 0x70, 0x72,
+  0x65, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x3e, 0x5d, 0x20, 0x5b, 0x66, 0x69,
+  0x6c, 0x65, 0x20, 0x7c, 0x20, 0x2d, 0x5d, 0x0d, 0x0a, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x63, 0x63, 0x61, 0x6c, 0x20, 0x5b, 0x2d,
+  0x2d, 0x73, 0x65, 0x72, 0x76, 0x65, 0x20, 0x3c, 0x73, 0x6f, 0x63, 0x6b,
+  0x65, 0x74, 0x3e, 0x20, 0x5b, 0x2d, 0x2d, 0x6c, 0x61, 0x74, 0x65, 0x6e,
+  0x63, 0x79, 0x5d, 0x5d, 0x20, 0x7c, 0x20, 0x5b, 0x2d, 0x2d, 0x73, 0x68,
+  0x6d, 0x20, 0x3c, 0x6e, 0x61, 0x6d, 0x65, 0x3e, 0x5d, 0x20, 0x7c, 0x20,
+  0x5b, 0x2d, 0x2d, 0x72, 0x65, 0x70, 0x6c, 0x5d, 0x0d, 0x0a, 0x0d, 0x0a,
+  0x20, 0x4f, 0x70, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x4c, 0x69, 0x73, 0x74,
+  0x3a, 0x0d, 0x0a, 0x0d, 0x0a, 0x20, 0x4f, 0x70, 0x74, 0x69, 0x6f, 0x6e,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x44, 0x65, 0x73, 0x63, 0x72, 0x69, 0x70, 0x74, 0x69, 0x6f, 0x6e, 0x0d,
+  0x0a, 0x20, 0x20, 0x2d, 0x68, 0x2c, 0x20, 0x2d, 0x2d, 0x68, 0x65, 0x6c,
+  0x70, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x4f, 0x75, 0x74,
+  0x70, 0x75, 0x74, 0x20, 0x74, 0x68, 0x65, 0x20, 0x63, 0x6f, 0x6e, 0x74,
+  0x65, 0x6e, 0x74, 0x73, 0x20, 0x6f, 0x66, 0x20, 0x74, 0x68, 0x65, 0x20,
+  0x68, 0x65, 0x6c, 0x70, 0x20, 0x28, 0x74, 0x68, 0x69, 0x73, 0x29, 0x20,
+  0x64, 0x6f, 0x63, 0x75, 0x6d, 0x65, 0x6e, 0x74, 0x2e, 0x0d, 0x0a, 0x20,
   0x20, 0x2d, 0x71, 0x2c, 0x20, 0x2d, 0x2d, 0x71, 0x75, 0x6f, 0x74, 0x65,
-  0x20, 0x61, 0x20, 0x73, 0x70, 0x61, 0x63, 0x65, 0x0d, 0x0a, 0x20, 0x20,
-  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
-  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
-  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x63, 0x68, 0x61, 0x72, 0x61, 0x63,
-  0x74, 0x65, 0x72, 0x20, 0x6d, 0x75, 0x73, 0x74, 0x20, 0x62, 0x65, 0x20,
-  0x62, 0x65, 0x74, 0x77, 0x65, 0x65, 0x6e, 0x20, 0x65, 0x61, 0x63, 0x68,
-  0x20, 0x69, 0x6e, 0x70, 0x75, 0x74, 0x2e, 0x0d, 0x0a, 0x20, 0x20, 0x20,
-  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
-  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
-  0x20, 0x20, 0x20, 0x20, 0x20, 0x0d, 0x0a, 0x20, 0x41, 0x63, 0x63, 0x65,
-  0x70, 0x74, 0x61, 0x62, 0x6c, 0x65, 0x20, 0x41, 0x72, 0x69, 0x74, 0x68,
-  0x6d, 0x65, 0x74, 0x69, 0x63, 0x20, 0x4f, 0x70, 0x65, 0x72, 0x61, 0x74,
-  0x6f, 0x72, 0x73, 0x3a, 0x0d, 0x0a, 0x20, 0x20, 0x2b, 0x20, 0x20, 0x2d,
-  0x3e, 0x20, 0x20, 0x61, 0x64, 0x64, 0x69, 0x74, 0x69, 0x6f, 0x6e, 0x0d,
-  0x0a, 0x20, 0x20, 0x2d, 0x20, 0x20, 0x2d, 0x3e, 0x20, 0x20, 0x73, 0x75,
-  0x62, 0x74, 0x72, 0x61, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x0d, 0x0a, 0x20,
-  0x20, 0x2f, 0x20, 0x20, 0x2d, 0x3e, 0x20, 0x20, 0x64, 0x69, 0x76, 0x69,
-  0x73, 0x69, 0x6f, 0x6e, 0x0d, 0x0a, 0x20, 0x20, 0x78, 0x20, 0x20, 0x2d,
-  0x3e, 0x20, 0x20, 0x6d, 0x75, 0x6c, 0x74, 0x69, 0x70, 0x6c, 0x69, 0x63,
-  0x61, 0x74, 0x69, 0x6f, 0x6e, 0x0d, 0x0a, 0x20, 0x20, 0x2a, 0x20, 0x20,
-  0x2d, 0x3e, 0x20, 0x20, 0x6d, 0x75, 0x6c, 0x74, 0x69, 0x70, 0x6c, 0x69,
-  0x63, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x28, 0x4e, 0x4f, 0x54, 0x45,
-  0x20, 0x2d, 0x20, 0x75, 0x73, 0x65, 0x20, 0x2d, 0x71, 0x2c, 0x20, 0x2d,
-  0x2d, 0x71, 0x75, 0x6f, 0x74, 0x65, 0x20, 0x74, 0x6f, 0x20, 0x75, 0x73,
-  0x65, 0x29, 0x0d, 0x0a, 0x20, 0x20, 0x70, 0x20, 0x20, 0x2d, 0x3e, 0x20,
-  0x20, 0x65, 0x78, 0x70, 0x6f, 0x6e, 0x65, 0x6e, 0x74, 0x69, 0x61, 0x74,
-  0x69, 0x6f, 0x6e, 0x20, 0x28, 0x70, 0x6f, 0x77, 0x65, 0x72, 0x20, 0x6f,
-  0x66, 0x29, 0x0d, 0x0a, 0x20, 0x20, 0x5e, 0x20, 0x20, 0x2d, 0x3e, 0x20,
-  0x20, 0x65, 0x78, 0x70, 0x6f, 0x6e, 0x65, 0x6e, 0x74, 0x69, 0x61, 0x74,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x55, 0x73, 0x65, 0x20, 0x71,
+  0x75, 0x6f, 0x74, 0x65, 0x73, 0x20, 0x66, 0x6f, 0x72, 0x20, 0x74, 0x68,
+  0x65, 0x20, 0x6d, 0x61, 0x74, 0x68, 0x65, 0x6d, 0x61, 0x74, 0x69, 0x63,
+  0x61, 0x6c, 0x20, 0x65, 0x78, 0x70, 0x72, 0x65, 0x73, 0x73, 0x69, 0x6f,
+  0x6e, 0x2e, 0x0d, 0x0a, 0x20, 0x20, 0x2d, 0x62, 0x2c, 0x20, 0x2d, 0x2d,
+  0x62, 0x61, 0x74, 0x63, 0x68, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x45, 0x76, 0x61, 0x6c, 0x75, 0x61, 0x74, 0x65, 0x20, 0x6f, 0x6e, 0x65,
+  0x20, 0x71, 0x75, 0x6f, 0x74, 0x65, 0x64, 0x20, 0x65, 0x78, 0x70, 0x72,
+  0x65, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x20, 0x70, 0x65, 0x72, 0x20, 0x6c,
+  0x69, 0x6e, 0x65, 0x20, 0x6f, 0x66, 0x20, 0x61, 0x20, 0x66, 0x69, 0x6c,
+  0x65, 0x2c, 0x20, 0x6f, 0x72, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x6f, 0x66, 0x20, 0x73, 0x74, 0x61, 0x6e, 0x64, 0x61,
+  0x72, 0x64, 0x20, 0x69, 0x6e, 0x70, 0x75, 0x74, 0x20, 0x77, 0x68, 0x65,
+  0x6e, 0x20, 0x74, 0x68, 0x65, 0x20, 0x66, 0x69, 0x6c, 0x65, 0x20, 0x69,
+  0x73, 0x20, 0x2d, 0x20, 0x6f, 0x72, 0x20, 0x6f, 0x6d, 0x69, 0x74, 0x74,
+  0x65, 0x64, 0x2e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x49, 0x6e, 0x76, 0x61, 0x6c, 0x69, 0x64, 0x20, 0x6c, 0x69, 0x6e,
+  0x65, 0x73, 0x20, 0x70, 0x72, 0x69, 0x6e, 0x74, 0x20, 0x22, 0x45, 0x72,
+  0x72, 0x6f, 0x72, 0x3a, 0x20, 0x49, 0x6e, 0x76, 0x61, 0x6c, 0x69, 0x64,
+  0x20, 0x65, 0x78, 0x70, 0x72, 0x65, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x22,
+  0x2e, 0x0d, 0x0a, 0x20, 0x20, 0x2d, 0x74, 0x2c, 0x20, 0x2d, 0x2d, 0x74,
+  0x68, 0x72, 0x65, 0x61, 0x64, 0x73, 0x20, 0x20, 0x20, 0x20, 0x20, 0x57,
+  0x69, 0x74, 0x68, 0x20, 0x2d, 0x62, 0x2c, 0x20, 0x2d, 0x2d, 0x62, 0x61,
+  0x74, 0x63, 0x68, 0x20, 0x65, 0x76, 0x61, 0x6c, 0x75, 0x61, 0x74, 0x65,
+  0x20, 0x6f, 0x6e, 0x20, 0x3c, 0x6e, 0x3e, 0x20, 0x77, 0x6f, 0x72, 0x6b,
+  0x65, 0x72, 0x20, 0x74, 0x68, 0x72, 0x65, 0x61, 0x64, 0x73, 0x20, 0x28,
+  0x30, 0x20, 0x75, 0x73, 0x65, 0x73, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x65, 0x76, 0x65, 0x72, 0x79, 0x20, 0x63, 0x6f,
+  0x72, 0x65, 0x29, 0x2e, 0x20, 0x4f, 0x75, 0x74, 0x70, 0x75, 0x74, 0x20,
+  0x6b, 0x65, 0x65, 0x70, 0x73, 0x20, 0x74, 0x68, 0x65, 0x20, 0x69, 0x6e,
+  0x70, 0x75, 0x74, 0x20, 0x6c, 0x69, 0x6e, 0x65, 0x20, 0x6f, 0x72, 0x64,
+  0x65, 0x72, 0x2e, 0x0d, 0x0a, 0x20, 0x20, 0x2d, 0x2d, 0x63, 0x61, 0x63,
+  0x68, 0x65, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x57, 0x69, 0x74, 0x68, 0x20, 0x2d, 0x62, 0x2c, 0x20, 0x2d, 0x2d,
+  0x62, 0x61, 0x74, 0x63, 0x68, 0x20, 0x72, 0x65, 0x6d, 0x65, 0x6d, 0x62,
+  0x65, 0x72, 0x20, 0x72, 0x65, 0x73, 0x75, 0x6c, 0x74, 0x73, 0x20, 0x6f,
+  0x66, 0x20, 0x75, 0x70, 0x20, 0x74, 0x6f, 0x20, 0x3c, 0x4b, 0x69, 0x42,
+  0x3e, 0x20, 0x6f, 0x66, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x65, 0x78, 0x70, 0x72, 0x65, 0x73, 0x73, 0x69, 0x6f, 0x6e,
+  0x73, 0x20, 0x61, 0x6e, 0x64, 0x20, 0x72, 0x65, 0x75, 0x73, 0x65, 0x20,
+  0x74, 0x68, 0x65, 0x6d, 0x20, 0x66, 0x6f, 0x72, 0x20, 0x72, 0x65, 0x70,
+  0x65, 0x61, 0x74, 0x65, 0x64, 0x20, 0x6c, 0x69, 0x6e, 0x65, 0x73, 0x2e,
+  0x0d, 0x0a, 0x20, 0x20, 0x2d, 0x2d, 0x63, 0x61, 0x63, 0x68, 0x65, 0x2d,
+  0x73, 0x74, 0x61, 0x74, 0x73, 0x20, 0x20, 0x20, 0x20, 0x20, 0x57, 0x69,
+  0x74, 0x68, 0x20, 0x2d, 0x62, 0x2c, 0x20, 0x2d, 0x2d, 0x62, 0x61, 0x74,
+  0x63, 0x68, 0x20, 0x70, 0x72, 0x69, 0x6e, 0x74, 0x20, 0x63, 0x61, 0x63,
+  0x68, 0x65, 0x20, 0x68, 0x69, 0x74, 0x73, 0x20, 0x61, 0x6e, 0x64, 0x20,
+  0x6d, 0x69, 0x73, 0x73, 0x65, 0x73, 0x20, 0x74, 0x6f, 0x0d, 0x0a, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x73, 0x74, 0x61, 0x6e, 0x64,
+  0x61, 0x72, 0x64, 0x20, 0x65, 0x72, 0x72, 0x6f, 0x72, 0x20, 0x61, 0x74,
+  0x20, 0x74, 0x68, 0x65, 0x20, 0x65, 0x6e, 0x64, 0x2e, 0x0d, 0x0a, 0x20,
+  0x20, 0x2d, 0x2d, 0x6c, 0x61, 0x74, 0x65, 0x6e, 0x63, 0x79, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x57, 0x69, 0x74, 0x68, 0x20,
+  0x2d, 0x62, 0x2c, 0x20, 0x2d, 0x2d, 0x62, 0x61, 0x74, 0x63, 0x68, 0x20,
+  0x6f, 0x72, 0x20, 0x2d, 0x2d, 0x73, 0x65, 0x72, 0x76, 0x65, 0x20, 0x70,
+  0x72, 0x69, 0x6e, 0x74, 0x20, 0x70, 0x35, 0x30, 0x2c, 0x20, 0x70, 0x39,
+  0x39, 0x2c, 0x20, 0x70, 0x39, 0x39, 0x2e, 0x39, 0x20, 0x61, 0x6e, 0x64,
+  0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x6d, 0x61,
+  0x78, 0x69, 0x6d, 0x75, 0x6d, 0x20, 0x65, 0x76, 0x61, 0x6c, 0x75, 0x61,
+  0x74, 0x65, 0x2c, 0x20, 0x66, 0x6f, 0x72, 0x6d, 0x61, 0x74, 0x20, 0x61,
+  0x6e, 0x64, 0x20, 0x63, 0x6f, 0x6e, 0x76, 0x65, 0x72, 0x74, 0x20, 0x74,
+  0x69, 0x6d, 0x65, 0x73, 0x20, 0x69, 0x6e, 0x20, 0x6e, 0x73, 0x20, 0x74,
+  0x6f, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x73,
+  0x74, 0x61, 0x6e, 0x64, 0x61, 0x72, 0x64, 0x20, 0x65, 0x72, 0x72, 0x6f,
+  0x72, 0x20, 0x61, 0x74, 0x20, 0x74, 0x68, 0x65, 0x20, 0x65, 0x6e, 0x64,
+  0x20, 0x61, 0x6e, 0x64, 0x20, 0x6f, 0x6e, 0x20, 0x53, 0x49, 0x47, 0x55,
+  0x53, 0x52, 0x31, 0x2e, 0x0d, 0x0a, 0x20, 0x20, 0x2d, 0x2d, 0x74, 0x72,
+  0x61, 0x63, 0x65, 0x2d, 0x73, 0x74, 0x61, 0x74, 0x73, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x42, 0x65, 0x66, 0x6f, 0x72, 0x65, 0x20, 0x61, 0x6e, 0x79,
+  0x20, 0x6f, 0x74, 0x68, 0x65, 0x72, 0x20, 0x6f, 0x70, 0x74, 0x69, 0x6f,
+  0x6e, 0x2c, 0x20, 0x70, 0x72, 0x69, 0x6e, 0x74, 0x20, 0x68, 0x6f, 0x77,
+  0x20, 0x6f, 0x66, 0x74, 0x65, 0x6e, 0x20, 0x74, 0x68, 0x65, 0x20, 0x70,
+  0x61, 0x72, 0x73, 0x65, 0x72, 0x20, 0x61, 0x6e, 0x64, 0x0d, 0x0a, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x63, 0x6f, 0x6e, 0x76, 0x65,
+  0x72, 0x74, 0x65, 0x72, 0x20, 0x69, 0x6e, 0x74, 0x65, 0x72, 0x6e, 0x61,
+  0x6c, 0x73, 0x20, 0x72, 0x61, 0x6e, 0x2c, 0x20, 0x61, 0x6e, 0x64, 0x20,
+  0x74, 0x68, 0x65, 0x20, 0x64, 0x65, 0x65, 0x70, 0x65, 0x73, 0x74, 0x20,
+  0x6e, 0x65, 0x73, 0x74, 0x69, 0x6e, 0x67, 0x2c, 0x20, 0x74, 0x6f, 0x0d,
+  0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x73, 0x74, 0x61,
+  0x6e, 0x64, 0x61, 0x72, 0x64, 0x20, 0x65, 0x72, 0x72, 0x6f, 0x72, 0x20,
+  0x61, 0x74, 0x20, 0x65, 0x78, 0x69, 0x74, 0x20, 0x28, 0x6e, 0x65, 0x65,
+  0x64, 0x73, 0x20, 0x2d, 0x44, 0x43, 0x43, 0x41, 0x4c, 0x5f, 0x54, 0x52,
+  0x41, 0x43, 0x45, 0x20, 0x62, 0x75, 0x69, 0x6c, 0x64, 0x73, 0x29, 0x2e,
+  0x0d, 0x0a, 0x20, 0x20, 0x2d, 0x63, 0x2c, 0x20, 0x2d, 0x2d, 0x63, 0x6f,
+  0x6c, 0x75, 0x6d, 0x6e, 0x73, 0x20, 0x20, 0x20, 0x20, 0x20, 0x45, 0x76,
+  0x61, 0x6c, 0x75, 0x61, 0x74, 0x65, 0x20, 0x61, 0x20, 0x71, 0x75, 0x6f,
+  0x74, 0x65, 0x64, 0x20, 0x65, 0x78, 0x70, 0x72, 0x65, 0x73, 0x73, 0x69,
+  0x6f, 0x6e, 0x20, 0x6f, 0x6e, 0x63, 0x65, 0x20, 0x70, 0x65, 0x72, 0x20,
+  0x72, 0x6f, 0x77, 0x20, 0x6f, 0x66, 0x20, 0x61, 0x20, 0x43, 0x53, 0x56,
+  0x20, 0x66, 0x69, 0x6c, 0x65, 0x2c, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x77, 0x68, 0x65, 0x72, 0x65, 0x20, 0x24, 0x31,
+  0x2c, 0x20, 0x24, 0x32, 0x2c, 0x20, 0x2e, 0x2e, 0x2e, 0x20, 0x73, 0x74,
+  0x61, 0x6e, 0x64, 0x20, 0x66, 0x6f, 0x72, 0x20, 0x74, 0x68, 0x65, 0x20,
+  0x72, 0x6f, 0x77, 0x27, 0x73, 0x20, 0x63, 0x6f, 0x6c, 0x75, 0x6d, 0x6e,
+  0x73, 0x2e, 0x20, 0x52, 0x6f, 0x77, 0x73, 0x20, 0x61, 0x72, 0x65, 0x0d,
+  0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x63, 0x6f, 0x6d,
+  0x70, 0x75, 0x74, 0x65, 0x64, 0x20, 0x69, 0x6e, 0x20, 0x64, 0x6f, 0x75,
+  0x62, 0x6c, 0x65, 0x73, 0x2c, 0x20, 0x6e, 0x6f, 0x74, 0x20, 0x65, 0x78,
+  0x61, 0x63, 0x74, 0x20, 0x64, 0x65, 0x63, 0x69, 0x6d, 0x61, 0x6c, 0x73,
+  0x2c, 0x20, 0x73, 0x6f, 0x20, 0x61, 0x20, 0x72, 0x65, 0x73, 0x75, 0x6c,
+  0x74, 0x20, 0x6f, 0x6e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x61, 0x20, 0x72, 0x6f, 0x75, 0x6e, 0x64, 0x69, 0x6e, 0x67,
+  0x20, 0x62, 0x6f, 0x75, 0x6e, 0x64, 0x61, 0x72, 0x79, 0x20, 0x6d, 0x61,
+  0x79, 0x20, 0x64, 0x69, 0x66, 0x66, 0x65, 0x72, 0x20, 0x69, 0x6e, 0x20,
+  0x69, 0x74, 0x73, 0x20, 0x6c, 0x61, 0x73, 0x74, 0x20, 0x64, 0x69, 0x67,
+  0x69, 0x74, 0x2e, 0x0d, 0x0a, 0x20, 0x20, 0x2d, 0x2d, 0x73, 0x65, 0x72,
+  0x76, 0x65, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x41, 0x6e, 0x73, 0x77, 0x65, 0x72, 0x20, 0x6f, 0x6e, 0x65, 0x20,
+  0x65, 0x78, 0x70, 0x72, 0x65, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x20, 0x6f,
+  0x72, 0x20, 0x2d, 0x6d, 0x20, 0x63, 0x6f, 0x6e, 0x76, 0x65, 0x72, 0x73,
+  0x69, 0x6f, 0x6e, 0x20, 0x70, 0x65, 0x72, 0x20, 0x6c, 0x69, 0x6e, 0x65,
+  0x20, 0x73, 0x65, 0x6e, 0x74, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x74, 0x6f, 0x20, 0x61, 0x20, 0x55, 0x6e, 0x69, 0x78,
+  0x20, 0x64, 0x6f, 0x6d, 0x61, 0x69, 0x6e, 0x20, 0x73, 0x6f, 0x63, 0x6b,
+  0x65, 0x74, 0x2c, 0x20, 0x75, 0x6e, 0x74, 0x69, 0x6c, 0x20, 0x69, 0x6e,
+  0x74, 0x65, 0x72, 0x72, 0x75, 0x70, 0x74, 0x65, 0x64, 0x20, 0x28, 0x4c,
+  0x69, 0x6e, 0x75, 0x78, 0x29, 0x2e, 0x0d, 0x0a, 0x20, 0x20, 0x2d, 0x2d,
+  0x73, 0x68, 0x6d, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x41, 0x6e, 0x73, 0x77, 0x65, 0x72, 0x20, 0x65,
+  0x78, 0x70, 0x72, 0x65, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x73, 0x20, 0x66,
+  0x72, 0x6f, 0x6d, 0x20, 0x74, 0x68, 0x65, 0x20, 0x63, 0x6c, 0x69, 0x65,
+  0x6e, 0x74, 0x20, 0x6c, 0x69, 0x62, 0x72, 0x61, 0x72, 0x79, 0x20, 0x69,
+  0x6e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x6d,
+  0x6f, 0x64, 0x75, 0x6c, 0x65, 0x73, 0x2f, 0x73, 0x68, 0x6d, 0x5f, 0x63,
+  0x6c, 0x69, 0x65, 0x6e, 0x74, 0x2e, 0x63, 0x20, 0x74, 0x68, 0x72, 0x6f,
+  0x75, 0x67, 0x68, 0x20, 0x73, 0x68, 0x61, 0x72, 0x65, 0x64, 0x2d, 0x6d,
+  0x65, 0x6d, 0x6f, 0x72, 0x79, 0x20, 0x72, 0x69, 0x6e, 0x67, 0x73, 0x2e,
+  0x0d, 0x0a, 0x20, 0x20, 0x2d, 0x2d, 0x72, 0x65, 0x70, 0x6c, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x45, 0x76,
+  0x61, 0x6c, 0x75, 0x61, 0x74, 0x65, 0x20, 0x65, 0x78, 0x70, 0x72, 0x65,
+  0x73, 0x73, 0x69, 0x6f, 0x6e, 0x73, 0x20, 0x61, 0x6e, 0x64, 0x20, 0x2d,
+  0x6d, 0x20, 0x63, 0x6f, 0x6e, 0x76, 0x65, 0x72, 0x73, 0x69, 0x6f, 0x6e,
+  0x73, 0x20, 0x74, 0x79, 0x70, 0x65, 0x64, 0x20, 0x6f, 0x6e, 0x65, 0x20,
+  0x70, 0x65, 0x72, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x6c, 0x69, 0x6e, 0x65, 0x2c, 0x20, 0x73, 0x68, 0x6f, 0x77, 0x69,
+  0x6e, 0x67, 0x20, 0x74, 0x68, 0x65, 0x20, 0x74, 0x69, 0x6d, 0x65, 0x20,
+  0x65, 0x61, 0x63, 0x68, 0x20, 0x74, 0x6f, 0x6f, 0x6b, 0x2e, 0x20, 0x41,
+  0x20, 0x6c, 0x69, 0x6e, 0x65, 0x20, 0x73, 0x74, 0x61, 0x72, 0x74, 0x69,
+  0x6e, 0x67, 0x20, 0x77, 0x69, 0x74, 0x68, 0x0d, 0x0a, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x61, 0x6e, 0x20, 0x6f, 0x70, 0x65, 0x72,
+  0x61, 0x74, 0x6f, 0x72, 0x2c, 0x20, 0x6f, 0x72, 0x20, 0x75, 0x73, 0x69,
+  0x6e, 0x67, 0x20, 0x61, 0x6e, 0x73, 0x2c, 0x20, 0x63, 0x6f, 0x6e, 0x74,
+  0x69, 0x6e, 0x75, 0x65, 0x73, 0x20, 0x66, 0x72, 0x6f, 0x6d, 0x20, 0x74,
+  0x68, 0x65, 0x20, 0x6c, 0x61, 0x73, 0x74, 0x20, 0x72, 0x65, 0x73, 0x75,
+  0x6c, 0x74, 0x2e, 0x0d, 0x0a, 0x20, 0x20, 0x65, 0x78, 0x70, 0x72, 0x65,
+  0x73, 0x73, 0x69, 0x6f, 0x6e, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x54, 0x68, 0x65, 0x20, 0x6d, 0x61, 0x74, 0x68, 0x65, 0x6d, 0x61,
+  0x74, 0x69, 0x63, 0x61, 0x6c, 0x20, 0x65, 0x78, 0x70, 0x72, 0x65, 0x73,
+  0x73, 0x69, 0x6f, 0x6e, 0x20, 0x74, 0x6f, 0x20, 0x63, 0x61, 0x6c, 0x63,
+  0x75, 0x6c, 0x61, 0x74, 0x65, 0x2e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x49, 0x4d, 0x50, 0x4f, 0x52, 0x54, 0x41, 0x4e,
+  0x54, 0x20, 0x2d, 0x20, 0x77, 0x68, 0x65, 0x6e, 0x20, 0x75, 0x73, 0x65,
+  0x64, 0x20, 0x77, 0x69, 0x74, 0x68, 0x6f, 0x75, 0x74, 0x20, 0x2d, 0x71,
+  0x2c, 0x20, 0x2d, 0x2d, 0x71, 0x75, 0x6f, 0x74, 0x65, 0x20, 0x61, 0x20,
+  0x73, 0x70, 0x61, 0x63, 0x65, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x63, 0x68, 0x61, 0x72, 0x61, 0x63, 0x74, 0x65, 0x72,
+  0x20, 0x6d, 0x75, 0x73, 0x74, 0x20, 0x62, 0x65, 0x20, 0x62, 0x65, 0x74,
+  0x77, 0x65, 0x65, 0x6e, 0x20, 0x65, 0x61, 0x63, 0x68, 0x20, 0x69, 0x6e,
+  0x70, 0x75, 0x74, 0x2e, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+  0x20, 0x20, 0x0d, 0x0a, 0x20, 0x41, 0x63, 0x63, 0x65, 0x70, 0x74, 0x61,
+  0x62, 0x6c, 0x65, 0x20, 0x41, 0x72, 0x69, 0x74, 0x68, 0x6d, 0x65, 0x74,
+  0x69, 0x63, 0x20, 0x4f, 0x70, 0x65, 0x72, 0x61, 0x74, 0x6f, 0x72, 0x73,
+  0x3a, 0x0d, 0x0a, 0x20, 0x20, 0x2b, 0x20, 0x20, 0x2d, 0x3e, 0x20, 0x20,
+  0x61, 0x64, 0x64, 0x69, 0x74, 0x69, 0x6f, 0x6e, 0x0d, 0x0a, 0x20, 0x20,
+  0x2d, 0x20, 0x20, 0x2d, 0x3e, 0x20, 0x20, 0x73, 0x75, 0x62, 0x74, 0x72,
+  0x61, 0x63, 0x74, 0x69, 0x6f, 0x6e, 0x0d, 0x0a, 0x20, 0x20, 0x2f, 0x20,
+  0x20, 0x2d, 0x3e, 0x20, 0x20, 0x64, 0x69, 0x76, 0x69, 0x73, 0x69, 0x6f,
+  0x6e, 0x0d, 0x0a, 0x20, 0x20, 0x78, 0x20, 0x20, 0x2d, 0x3e, 0x20, 0x20,
+  0x6d, 0x75, 0x6c, 0x74, 0x69, 0x70, 0x6c, 0x69, 0x63, 0x61, 0x74, 0x69,
+  0x6f, 0x6e, 0x0d, 0x0a, 0x20, 0x20, 0x2a, 0x20, 0x20, 0x2d, 0x3e, 0x20,
+  0x20, 0x6d, 0x75, 0x6c, 0x74, 0x69, 0x70, 0x6c, 0x69, 0x63, 0x61, 0x74,
   0x69, 0x6f, 0x6e, 0x20, 0x28, 0x4e, 0x4f, 0x54, 0x45, 0x20, 0x2d, 0x20,
   0x75, 0x73, 0x65, 0x20, 0x2d, 0x71, 0x2c, 0x20, 0x2d, 0x2d, 0x71, 0x75,
-  0x6f, 0x74, 0x65, 0x20, 0x74, 0x6f, 0x20, 0x75, 0x73, 0x65, 0x29, 0x20,
-  0x0d, 0x0a, 0x0d, 0x0a, 0x20, 0x55, 0x73, 0x65, 0x20, 0x45, 0x78, 0x61,
-  0x6d, 0x70, 0x6c, 0x65, 0x3a, 0x0d, 0x0a, 0x20, 0x20, 0x3e, 0x20, 0x63,
-  0x63, 0x61, 0x6c, 0x20, 0x31, 0x20, 0x2b, 0x20, 0x31, 0x0d, 0x0a, 0x20,
+  0x6f, 0x74, 0x65, 0x20, 0x74, 0x6f, 0x20, 0x75, 0x73, 0x65, 0x29, 0x0d,
+  0x0a, 0x20, 0x20, 0x70, 0x20, 0x20, 0x2d, 0x3e, 0x20, 0x20, 0x65, 0x78,
+  0x70, 0x6f, 0x6e, 0x65, 0x6e, 0x74, 0x69, 0x61, 0x74, 0x69, 0x6f, 0x6e,
+  0x20, 0x28, 0x70, 0x6f, 0x77, 0x65, 0x72, 0x20, 0x6f, 0x66, 0x29, 0x0d,
+  0x0a, 0x20, 0x20, 0x5e, 0x20, 0x20, 0x2d, 0x3e, 0x20, 0x20, 0x65, 0x78,
+  0x70, 0x6f, 0x6e, 0x65, 0x6e, 0x74, 0x69, 0x61, 0x74, 0x69, 0x6f, 0x6e,
+  0x20, 0x28, 0x4e, 0x4f, 0x54, 0x45, 0x20, 0x2d, 0x20, 0x75, 0x73, 0x65,
+  0x20, 0x2d, 0x71, 0x2c, 0x20, 0x2d, 0x2d, 0x71, 0x75, 0x6f, 0x74, 0x65,
+  0x20, 0x74, 0x6f, 0x20, 0x75, 0x73, 0x65, 0x29, 0x20, 0x0d, 0x0a, 0x0d,
+  0x0a, 0x20, 0x55, 0x73, 0x65, 0x20, 0x45, 0x78, 0x61, 0x6d, 0x70, 0x6c,
+  0x65, 0x3a, 0x0d, 0x0a, 0x20, 0x20, 0x3e, 0x20, 0x63, 0x63, 0x61, 0x6c,
+  0x20, 0x31, 0x20, 0x2b, 0x20, 0x31, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20,
+  0x2d, 0x20, 0x43, 0x61, 0x6c, 0x63, 0x75, 0x6c, 0x61, 0x74, 0x65, 0x20,
+  0x61, 0x20, 0x6d, 0x61, 0x74, 0x68, 0x65, 0x6d, 0x61, 0x74, 0x69, 0x63,
+  0x61, 0x6c, 0x20, 0x65, 0x78, 0x70, 0x72, 0x65, 0x73, 0x73, 0x69, 0x6f,
+  0x6e, 0x2e, 0x0d, 0x0a, 0x20, 0x20, 0x3e, 0x20, 0x63, 0x63, 0x61, 0x6c,
+  0x20, 0x2d, 0x2d, 0x71, 0x75, 0x6f, 0x74, 0x65, 0x20, 0x22, 0x31, 0x2b,
+  0x31, 0x22, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x2d, 0x20, 0x43, 0x61,
+  0x6c, 0x63, 0x75, 0x6c, 0x61, 0x74, 0x65, 0x20, 0x61, 0x20, 0x6d, 0x61,
+  0x74, 0x68, 0x65, 0x6d, 0x61, 0x74, 0x69, 0x63, 0x61, 0x6c, 0x20, 0x65,
+  0x78, 0x70, 0x72, 0x65, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x20, 0x75, 0x73,
+  0x69, 0x6e, 0x67, 0x20, 0x71, 0x75, 0x6f, 0x74, 0x65, 0x73, 0x2e, 0x0d,
+  0x0a, 0x20, 0x20, 0x3e, 0x20, 0x63, 0x63, 0x61, 0x6c, 0x20, 0x32, 0x20,
+  0x70, 0x20, 0x32, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x2d, 0x20, 0x43,
+  0x61, 0x6c, 0x63, 0x75, 0x6c, 0x61, 0x74, 0x65, 0x20, 0x74, 0x68, 0x65,
+  0x20, 0x65, 0x78, 0x70, 0x6f, 0x6e, 0x65, 0x6e, 0x74, 0x69, 0x61, 0x74,
+  0x69, 0x6f, 0x6e, 0x20, 0x6f, 0x66, 0x20, 0x61, 0x20, 0x6d, 0x61, 0x74,
+  0x68, 0x65, 0x6d, 0x61, 0x74, 0x69, 0x63, 0x61, 0x6c, 0x20, 0x65, 0x78,
+  0x70, 0x72, 0x65, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x2e, 0x0d, 0x0a, 0x20,
+  0x20, 0x3e, 0x20, 0x63, 0x63, 0x61, 0x6c, 0x20, 0x2d, 0x71, 0x20, 0x22,
+  0x32, 0x5e, 0x32, 0x22, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x2d, 0x20,
+  0x43, 0x61, 0x6c, 0x63, 0x75, 0x6c, 0x61, 0x74, 0x65, 0x20, 0x74, 0x68,
+  0x65, 0x20, 0x65, 0x78, 0x70, 0x6f, 0x6e, 0x65, 0x6e, 0x74, 0x69, 0x61,
+  0x74, 0x69, 0x6f, 0x6e, 0x20, 0x6f, 0x66, 0x20, 0x61, 0x20, 0x6d, 0x61,
+  0x74, 0x68, 0x65, 0x6d, 0x61, 0x74, 0x69, 0x63, 0x61, 0x6c, 0x20, 0x65,
+  0x78, 0x70, 0x72, 0x65, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x20, 0x75, 0x73,
+  0x69, 0x6e, 0x67, 0x20, 0x71, 0x75, 0x6f, 0x74, 0x65, 0x73, 0x2e, 0x0d,
+  0x0a, 0x20, 0x20, 0x3e, 0x20, 0x63, 0x63, 0x61, 0x6c, 0x20, 0x2d, 0x2d,
+  0x62, 0x61, 0x74, 0x63, 0x68, 0x20, 0x65, 0x78, 0x70, 0x72, 0x65, 0x73,
+  0x73, 0x69, 0x6f, 0x6e, 0x73, 0x2e, 0x74, 0x78, 0x74, 0x0d, 0x0a, 0x20,
   0x20, 0x20, 0x20, 0x2d, 0x20, 0x43, 0x61, 0x6c, 0x63, 0x75, 0x6c, 0x61,
-  0x74, 0x65, 0x20, 0x61, 0x20, 0x6d, 0x61, 0x74, 0x68, 0x65, 0x6d, 0x61,
-  0x74, 0x69, 0x63, 0x61, 0x6c, 0x20, 0x65, 0x78, 0x70, 0x72, 0x65, 0x73,
-  0x73, 0x69, 0x6f, 0x6e, 0x2e, 0x0d, 0x0a, 0x20, 0x20, 0x3e, 0x20, 0x63,
-  0x63, 0x61, 0x6c, 0x20, 0x2d, 0x2d, 0x71, 0x75, 0x6f, 0x74, 0x65, 0x20,
-  0x22, 0x31, 0x2b, 0x31, 0x22, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x2d,
+  0x74, 0x65, 0x20, 0x65, 0x76, 0x65, 0x72, 0x79, 0x20, 0x65, 0x78, 0x70,
+  0x72, 0x65, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x20, 0x69, 0x6e, 0x20, 0x61,
+  0x20, 0x66, 0x69, 0x6c, 0x65, 0x2c, 0x20, 0x6f, 0x6e, 0x65, 0x20, 0x72,
+  0x65, 0x73, 0x75, 0x6c, 0x74, 0x20, 0x70, 0x65, 0x72, 0x20, 0x6c, 0x69,
+  0x6e, 0x65, 0x2e, 0x0d, 0x0a, 0x20, 0x20, 0x3e, 0x20, 0x63, 0x63, 0x61,
+  0x6c, 0x20, 0x2d, 0x2d, 0x63, 0x6f, 0x6c, 0x75, 0x6d, 0x6e, 0x73, 0x20,
+  0x27, 0x28, 0x24, 0x31, 0x20, 0x2d, 0x20, 0x24, 0x32, 0x29, 0x20, 0x78,
+  0x20, 0x31, 0x2e, 0x30, 0x38, 0x27, 0x20, 0x72, 0x65, 0x70, 0x6f, 0x72,
+  0x74, 0x2e, 0x63, 0x73, 0x76, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x2d,
   0x20, 0x43, 0x61, 0x6c, 0x63, 0x75, 0x6c, 0x61, 0x74, 0x65, 0x20, 0x61,
-  0x20, 0x6d, 0x61, 0x74, 0x68, 0x65, 0x6d, 0x61, 0x74, 0x69, 0x63, 0x61,
-  0x6c, 0x20, 0x65, 0x78, 0x70, 0x72, 0x65, 0x73, 0x73, 0x69, 0x6f, 0x6e,
-  0x20, 0x75, 0x73, 0x69, 0x6e, 0x67, 0x20, 0x71, 0x75, 0x6f, 0x74, 0x65,
-  0x73, 0x2e, 0x0d, 0x0a, 0x20, 0x20, 0x3e, 0x20, 0x63, 0x63, 0x61, 0x6c,
-  0x20, 0x32, 0x20, 0x70, 0x20, 0x32, 0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20,
-  0x2d, 0x20, 0x43, 0x61, 0x6c, 0x63, 0x75, 0x6c, 0x61, 0x74, 0x65, 0x20,
-  0x74, 0x68, 0x65, 0x20, 0x65, 0x78, 0x70, 0x6f, 0x6e, 0x65, 0x6e, 0x74,
-  0x69, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x6f, 0x66, 0x20, 0x61, 0x20,
-  0x6d, 0x61, 0x74, 0x68, 0x65, 0x6d, 0x61, 0x74, 0x69, 0x63, 0x61, 0x6c,
-  0x20, 0x65, 0x78, 0x70, 0x72, 0x65, 0x73, 0x73, 0x69, 0x6f, 0x6e, 0x2e,
-  0x0d, 0x0a, 0x20, 0x20, 0x3e, 0x20, 0x63, 0x63, 0x61, 0x6c, 0x20, 0x2d,
-  0x71, 0x20, 0x22, 0x32, 0x5e, 0x32, 0x22, 0x0d, 0x0a, 0x20, 0x20, 0x20,
-  0x20, 0x2d, 0x20, 0x43, 0x61, 0x6c, 0x63, 0x75, 0x6c, 0x61, 0x74, 0x65,
-  0x20, 0x74, 0x68, 0x65, 0x20, 0x65, 0x78, 0x70, 0x6f, 0x6e, 0x65, 0x6e,
-  0x74, 0x69, 0x61, 0x74, 0x69, 0x6f, 0x6e, 0x20, 0x6f, 0x66, 0x20, 0x61,
-  0x20, 0x6d, 0x61, 0x74, 0x68, 0x65, 0x6d, 0x61, 0x74, 0x69, 0x63, 0x61,
-  0x6c, 0x20, 0x65, 0x78, 0x70, 0x72, 0x65, 0x73, 0x73, 0x69, 0x6f, 0x6e,
-  0x20, 0x75, 0x73, 0x69, 0x6e, 0x67, 0x20, 0x71, 0x75, 0x6f, 0x74, 0x65,
-  0x73, 0x2e, 0x0d, 0x0a
+  0x20, 0x66, 0x6f, 0x72, 0x6d, 0x75, 0x6c, 0x61, 0x20, 0x6f, 0x76, 0x65,
+  0x72, 0x20, 0x74, 0x68, 0x65, 0x20, 0x63, 0x6f, 0x6c, 0x75, 0x6d, 0x6e,
+  0x73, 0x20, 0x6f, 0x66, 0x20, 0x65, 0x76, 0x65, 0x72, 0x79, 0x20, 0x43,
+  0x53, 0x56, 0x20, 0x72, 0x6f, 0x77, 0x2e, 0x0d, 0x0a, 0x20, 0x20, 0x3e,
+  0x20, 0x63, 0x63, 0x61, 0x6c, 0x20, 0x2d, 0x2d, 0x72, 0x65, 0x70, 0x6c,
+  0x0d, 0x0a, 0x20, 0x20, 0x20, 0x20, 0x2d, 0x20, 0x43, 0x61, 0x6c, 0x63,
+  0x75, 0x6c, 0x61, 0x74, 0x65, 0x20, 0x69, 0x6e, 0x74, 0x65, 0x72, 0x61,
+  0x63, 0x74, 0x69, 0x76, 0x65, 0x6c, 0x79, 0x2c, 0x20, 0x72, 0x65, 0x75,
+  0x73, 0x69, 0x6e, 0x67, 0x20, 0x74, 0x68, 0x65, 0x20, 0x6c, 0x61, 0x73,
+  0x74, 0x20, 0x72, 0x65, 0x73, 0x75, 0x6c, 0x74, 0x20, 0x61, 0x73, 0x20,
+  0x61, 0x6e, 0x73, 0x2e, 0x0d, 0x0a
 };
-unsigned int help_txt_len = 1192;
+unsigned int help_txt_len = 3618;
@@ -0,0 +1,904 @@
+// modules/batch.c
+// Batch evaluation module for ccal calculator
+// Reads newline-delimited expressions and writes one result per line
+// Keeps a single process alive so large inputs avoid per-expression startup
+// With more than one thread, input is cut into chunks that a work-stealing
+// pool evaluates while a reorder buffer keeps output in input order
+// Regular files are memory-mapped and evaluated in place, line by line
+// An optional result cache per thread answers repeated expressions
+// Columns mode compiles one expression and runs it over blocks of CSV rows
+// With --latency every thread records how long each line spends in
+// evaluation and formatting into its own histograms
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <signal.h>
+#include <unistd.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "../ccal.h"
+#include "batch.h"
+#include "latency.h"
+
+// Initial size of the reusable line buffer
+#define BATCH_LINE_LEN 512
+
+// Size of the stdout buffer used while writing results
+#define BATCH_OUT_BUF (1 << 16)
+
+// Bytes of input read per chunk in parallel mode
+#define BATCH_CHUNK_SIZE (1 << 20)
+
+// Chunks in flight per worker before the reader waits for output
+#define BATCH_WINDOW_PER_THREAD 4
+
+// Upper bound on --threads
+#define BATCH_MAX_THREADS 256
+
+// Longest result line: formatted number plus newline
+#define BATCH_RESULT_LEN 66
+
+// Set by SIGUSR1 to ask for the latency histograms so far
+static volatile sig_atomic_t batch_dump = 0;
+
+#ifdef SIGUSR1
+static void batch_signal(int sig) {
+    (void)sig;
+    batch_dump = 1;
+}
+#endif
+
+// Read one line into a growable buffer, without the trailing newline.
+// Returns the line length, or -1 at end of input.
+static long read_line(FILE* fp, char** buf, size_t* cap) {
+    size_t len = 0;
+
+    while (fgets(*buf + len, (int)(*cap - len), fp)) {
+        len += strlen(*buf + len);
+        if (len > 0 && (*buf)[len - 1] == '\n') {
+            (*buf)[--len] = '\0';
+            break;
+        }
+        if (len + 1 < *cap)
+            break;  // last line without newline
+
+        // Line did not fit, grow the buffer and keep reading
+        char* grown = realloc(*buf, *cap * 2);
+        if (!grown)
+            return -1;
+        *buf = grown;
+        *cap *= 2;
+    }
+
+    if (len == 0 && feof(fp))
+        return -1;
+    return (long)len;
+}
+
+// Evaluate one expression line, given as a span that is neither copied nor
+// modified, with an initialized context and cache reused from line to line,
+// and write its result line to out, which must hold BATCH_RESULT_LEN bytes.
+// When lat is not NULL the time spent evaluating and formatting is recorded
+// in it. Returns the number of bytes written; *ok is cleared if the line is
+// not a valid expression.
+static size_t evaluate_line(ccal_ctx* ctx, ccal_cache* cache, latency_set* lat,
+                            const char* line, size_t len, char* out, int* ok) {
+    int error;
+    uint64_t t0 = lat ? latency_now() : 0;
+
+    // Accept CRLF input produced on Windows
+    if (len > 0 && line[len - 1] == '\r')
+        len--;
+
+    ccal_result res = ccal_cache_evaluate(cache, ctx, line, len, &error);
+    if (lat) {
+        uint64_t t1 = latency_now();
+        latency_record(&lat->stage[LATENCY_EVALUATE], t1 - t0);
+        t0 = t1;
+    }
+    if (error) {
+        *ok = 0;
+        memcpy(out, BATCH_ERROR_MARKER "\n", sizeof(BATCH_ERROR_MARKER));
+        return sizeof(BATCH_ERROR_MARKER);
+    }
+
+    size_t out_len = ccal_write_result(&res, 0, out);
+    out[out_len++] = '\n';
+    if (lat)
+        latency_record(&lat->stage[LATENCY_FORMAT], latency_now() - t0);
+    return out_len;
+}
+
+// Print the histograms when SIGUSR1 asked for them.
+static void check_dump(const latency_set* lat) {
+    if (batch_dump && lat) {
+        batch_dump = 0;
+        latency_print(stderr, lat);
+    }
+}
+
+// Evaluate every newline-separated line of a buffer, writing results to stdout.
+static int evaluate_buffer(const char* p, size_t len, ccal_cache* cache, latency_set* lat) {
+    ccal_ctx ctx;
+    char out[BATCH_RESULT_LEN];
+    int ok = 1;
+    const char* end = p + len;
+
+    ccal_ctx_init(&ctx);
+    while (p < end) {
+        const char* nl = memchr(p, '\n', end - p);
+        const char* line_end = nl ? nl : end;
+        size_t out_len = evaluate_line(&ctx, cache, lat, p, line_end - p, out, &ok);
+        fwrite(out, 1, out_len, stdout);
+        p = line_end + 1;
+        check_dump(lat);
+    }
+    ccal_ctx_free(&ctx);
+    return !ok;
+}
+
+// Evaluate lines one at a time on the calling thread.
+static int run_batch_serial(FILE* fp, ccal_cache* cache, latency_set* lat) {
+    size_t cap = BATCH_LINE_LEN;
+    char* line = malloc(cap);
+    if (!line) {
+        fprintf(stderr, "Memory error\n");
+        return 1;
+    }
+
+    ccal_ctx ctx;
+    char out[BATCH_RESULT_LEN];
+    int ok = 1;
+    long len;
+    ccal_ctx_init(&ctx);
+    while ((len = read_line(fp, &line, &cap)) >= 0) {
+        size_t out_len = evaluate_line(&ctx, cache, lat, line, (size_t)len, out, &ok);
+        fwrite(out, 1, out_len, stdout);
+        check_dump(lat);
+    }
+
+    ccal_ctx_free(&ctx);
+    free(line);
+    return !ok;
+}
+
+/*****************************************************************************
+*  PARALLEL BATCH:                                                           *
+*****************************************************************************/
+
+// A run of complete input lines and the results produced for them
+typedef struct {
+    const char* in;    // input text, read-only
+    size_t in_len;     // bytes of input
+    char* owned;       // buffer to free when the input was read, not mapped
+    char* out;         // formatted results, one line per input line
+    size_t out_len;    // bytes of output
+    int ok;            // cleared if any line failed
+    int done;          // set by the worker once out is complete
+} BatchChunk;
+
+// Per-worker double-ended queue of chunks
+typedef struct {
+    pthread_mutex_t lock;
+    BatchChunk** items;  // ring buffer of queued chunks
+    int head;            // next chunk for the owner
+    int count;           // number of queued chunks
+} BatchDeque;
+
+// Shared state of the worker pool
+typedef struct {
+    int workers;
+    int window;              // size of the reorder buffer
+    BatchDeque* deques;      // one deque per worker
+    pthread_mutex_t lock;    // guards pending, shutdown and chunk done flags
+    pthread_cond_t work_cv;  // signalled when a chunk is queued
+    pthread_cond_t done_cv;  // signalled when a chunk is finished
+    int pending;             // queued chunks not yet taken by a worker
+    int shutdown;            // set once all input has been queued
+    size_t cache;            // result cache bytes of each worker
+} BatchPool;
+
+// Worker start argument
+typedef struct {
+    BatchPool* pool;
+    int id;
+    ccal_cache cache;  // worker's own result cache, read after it exits
+    latency_set* latency;  // worker's own histograms, NULL without --latency
+} BatchWorker;
+
+// Take the oldest chunk from a worker's own deque.
+static BatchChunk* deque_pop(BatchDeque* dq, int window) {
+    BatchChunk* chunk = NULL;
+    pthread_mutex_lock(&dq->lock);
+    if (dq->count > 0) {
+        chunk = dq->items[dq->head];
+        dq->head = (dq->head + 1) % window;
+        dq->count--;
+    }
+    pthread_mutex_unlock(&dq->lock);
+    return chunk;
+}
+
+// Take the newest chunk from another worker's deque.
+static BatchChunk* deque_steal(BatchDeque* dq, int window) {
+    BatchChunk* chunk = NULL;
+    pthread_mutex_lock(&dq->lock);
+    if (dq->count > 0) {
+        dq->count--;
+        chunk = dq->items[(dq->head + dq->count) % window];
+    }
+    pthread_mutex_unlock(&dq->lock);
+    return chunk;
+}
+
+// Queue a chunk on a worker's deque.
+static void deque_push(BatchDeque* dq, BatchChunk* chunk, int window) {
+    pthread_mutex_lock(&dq->lock);
+    dq->items[(dq->head + dq->count) % window] = chunk;
+    dq->count++;
+    pthread_mutex_unlock(&dq->lock);
+}
+
+// Evaluate every line of a chunk into its output buffer.
+static void process_chunk(ccal_ctx* ctx, ccal_cache* cache, latency_set* lat, BatchChunk* chunk) {
+    // Results are at most BATCH_RESULT_LEN bytes; grow only for long inputs
+    size_t cap = chunk->in_len + BATCH_RESULT_LEN;
+    chunk->out = malloc(cap);
+    chunk->out_len = 0;
+    chunk->ok = 1;
+    if (!chunk->out) {
+        chunk->ok = 0;
+        return;
+    }
+
+    const char* p = chunk->in;
+    const char* end = chunk->in + chunk->in_len;
+    while (p < end) {
+        const char* nl = memchr(p, '\n', end - p);
+        const char* line_end = nl ? nl : end;
+
+        if (chunk->out_len + BATCH_RESULT_LEN > cap) {
+            char* grown = realloc(chunk->out, cap * 2);
+            if (!grown) {
+                chunk->ok = 0;
+                return;
+            }
+            chunk->out = grown;
+            cap *= 2;
+        }
+        chunk->out_len += evaluate_line(ctx, cache, lat, p, line_end - p,
+                                        chunk->out + chunk->out_len, &chunk->ok);
+        p = line_end + 1;
+    }
+}
+
+// Worker loop: drain the own deque, steal when it is empty, sleep when idle.
+static void* batch_worker(void* arg) {
+    BatchWorker* self = arg;
+    BatchPool* pool = self->pool;
+    ccal_ctx ctx;  // per-thread evaluator state
+    ccal_ctx_init(&ctx);
+    ccal_cache_init(&self->cache, pool->cache);
+
+    for (;;) {
+        BatchChunk* chunk = deque_pop(&pool->deques[self->id], pool->window);
+        for (int i = 1; !chunk && i < pool->workers; i++)
+            chunk = deque_steal(&pool->deques[(self->id + i) % pool->workers], pool->window);
+
+        pthread_mutex_lock(&pool->lock);
+        if (!chunk) {
+            if (pool->pending == 0 && pool->shutdown) {
+                pthread_mutex_unlock(&pool->lock);
+                ccal_ctx_free(&ctx);
+                return NULL;
+            }
+            if (pool->pending == 0)
+                pthread_cond_wait(&pool->work_cv, &pool->lock);
+            pthread_mutex_unlock(&pool->lock);
+            continue;
+        }
+        pool->pending--;
+        pthread_mutex_unlock(&pool->lock);
+
+        process_chunk(&ctx, &self->cache, self->latency, chunk);
+
+        pthread_mutex_lock(&pool->lock);
+        chunk->done = 1;
+        pthread_cond_broadcast(&pool->done_cv);
+        pthread_mutex_unlock(&pool->lock);
+    }
+}
+
+// Input split into chunks of complete lines
+typedef struct {
+    FILE* fp;
+    const char* map;   // mapped input, or NULL to read from fp
+    size_t map_len;
+    size_t map_pos;    // start of the next mapped chunk
+    char* carry;       // partial line left over from the previous read
+    size_t carry_len;
+    size_t carry_cap;
+    int error;         // set on allocation failure
+} BatchReader;
+
+// Cut the next run of complete lines out of the mapped input, no copy.
+static BatchChunk* map_chunk(BatchReader* rd) {
+    if (rd->map_pos >= rd->map_len)
+        return NULL;
+
+    const char* start = rd->map + rd->map_pos;
+    size_t len = rd->map_len - rd->map_pos;
+    if (len > BATCH_CHUNK_SIZE) {
+        // End the chunk after the last newline within the chunk size, or
+        // after the first newline when one line is longer than a chunk
+        const char* nl = start + BATCH_CHUNK_SIZE;
+        while (nl > start && nl[-1] != '\n')
+            nl--;
+        if (nl == start) {
+            nl = memchr(start + BATCH_CHUNK_SIZE, '\n', len - BATCH_CHUNK_SIZE);
+            nl = nl ? nl + 1 : start + len;
+        }
+        len = nl - start;
+    }
+    rd->map_pos += len;
+
+    BatchChunk* chunk = calloc(1, sizeof(BatchChunk));
+    if (!chunk) {
+        rd->error = 1;
+        return NULL;
+    }
+    chunk->in = start;
+    chunk->in_len = len;
+    return chunk;
+}
+
+// Read the next run of complete lines into a new chunk.
+// Returns NULL at end of input or on allocation failure.
+static BatchChunk* read_chunk(BatchReader* rd) {
+    if (rd->map)
+        return map_chunk(rd);
+
+    size_t cap = BATCH_CHUNK_SIZE;
+    size_t len = rd->carry_len;
+    if (len >= cap)
+        cap = len * 2;
+
+    char* buf = malloc(cap);
+    if (!buf) {
+        rd->error = 1;
+        return NULL;
+    }
+    memcpy(buf, rd->carry, len);
+    rd->carry_len = 0;
+
+    for (;;) {
+        len += fread(buf + len, 1, cap - len, rd->fp);
+        if (len < cap)
+            break;  // end of input
+
+        // Cut at the last newline; keep the partial line for the next chunk
+        char* nl = buf + len;
+        while (nl > buf && nl[-1] != '\n')
+            nl--;
+        if (nl > buf) {
+            size_t tail = buf + len - nl;
+            if (tail > rd->carry_cap) {
+                char* grown = realloc(rd->carry, tail);
+                if (!grown) {
+                    free(buf);
+                    rd->error = 1;
+                    return NULL;
+                }
+                rd->carry = grown;
+                rd->carry_cap = tail;
+            }
+            memcpy(rd->carry, nl, tail);
+            rd->carry_len = tail;
+            len = nl - buf;
+            break;
+        }
+
+        // A single line longer than the chunk, grow and keep reading
+        char* grown = realloc(buf, cap * 2);
+        if (!grown) {
+            free(buf);
+            rd->error = 1;
+            return NULL;
+        }
+        buf = grown;
+        cap *= 2;
+    }
+
+    if (len == 0) {
+        free(buf);
+        return NULL;
+    }
+
+    BatchChunk* chunk = calloc(1, sizeof(BatchChunk));
+    if (!chunk) {
+        free(buf);
+        rd->error = 1;
+        return NULL;
+    }
+    chunk->in = buf;
+    chunk->in_len = len;
+    chunk->owned = buf;
+    return chunk;
+}
+
+// Wait for a chunk to finish, write its results and release it.
+static int flush_chunk(BatchPool* pool, BatchChunk* chunk) {
+    pthread_mutex_lock(&pool->lock);
+    while (!chunk->done)
+        pthread_cond_wait(&pool->done_cv, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+
+    fwrite(chunk->out, 1, chunk->out_len, stdout);
+    int ok = chunk->ok;
+    free(chunk->owned);
+    free(chunk->out);
+    free(chunk);
+    return ok;
+}
+
+// Sum the histograms of every worker into a new set and print it, while
+// the workers keep recording.
+static void dump_workers(const BatchWorker* workers, int count) {
+    latency_set* sum = latency_create();
+    if (!sum)
+        return;
+    for (int i = 0; i < count; i++)
+        latency_merge(sum, workers[i].latency);
+    latency_print(stderr, sum);
+    free(sum);
+}
+
+// Evaluate input on a pool of worker threads, writing results in input order.
+// The workers' cache counters are summed into *stats and, when lat is not
+// NULL, their histograms into lat.
+static int run_batch_parallel(FILE* fp, const char* map, size_t map_len, int threads,
+                              size_t cache, ccal_cache* stats, latency_set* lat) {
+    BatchPool pool;
+    memset(&pool, 0, sizeof(pool));
+    pool.workers = threads;
+    pool.window = threads * BATCH_WINDOW_PER_THREAD;
+    pool.cache = cache / threads;
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.work_cv, NULL);
+    pthread_cond_init(&pool.done_cv, NULL);
+
+    // The reorder buffer holds chunks in input order until they are written
+    BatchChunk** reorder = calloc(pool.window, sizeof(BatchChunk*));
+    BatchWorker* workers = calloc(threads, sizeof(BatchWorker));
+    pthread_t* tids = calloc(threads, sizeof(pthread_t));
+    pool.deques = calloc(threads, sizeof(BatchDeque));
+    BatchReader reader = { fp, map, map_len, 0, NULL, 0, 0, 0 };
+    int ok = reorder && workers && tids && pool.deques;
+
+    int started = 0;
+    for (int i = 0; ok && i < threads; i++) {
+        pool.deques[i].items = calloc(pool.window, sizeof(BatchChunk*));
+        if (!pool.deques[i].items) {
+            ok = 0;
+            break;
+        }
+        pthread_mutex_init(&pool.deques[i].lock, NULL);
+        workers[i].pool = &pool;
+        workers[i].id = i;
+        if (lat && !(workers[i].latency = latency_create())) {
+            ok = 0;
+            break;
+        }
+        if (pthread_create(&tids[i], NULL, batch_worker, &workers[i]) != 0) {
+            ok = 0;
+            break;
+        }
+        started++;
+    }
+    if (!ok) {
+        fprintf(stderr, "Error: Cannot start batch worker threads\n");
+        pool.workers = started;
+    }
+
+    // Reader loop: queue chunks round-robin, flushing the oldest when the
+    // reorder buffer is full so memory stays bounded
+    long next_in = 0;
+    long next_out = 0;
+    int failed = !ok;
+    while (ok) {
+        if (next_in - next_out == pool.window)
+            failed |= !flush_chunk(&pool, reorder[next_out++ % pool.window]);
+
+        BatchChunk* chunk = read_chunk(&reader);
+        if (!chunk)
+            break;
+        reorder[next_in % pool.window] = chunk;
+        deque_push(&pool.deques[next_in % pool.workers], chunk, pool.window);
+        next_in++;
+
+        pthread_mutex_lock(&pool.lock);
+        pool.pending++;
+        pthread_cond_signal(&pool.work_cv);
+        pthread_mutex_unlock(&pool.lock);
+
+        if (batch_dump && lat) {
+            batch_dump = 0;
+            dump_workers(workers, started);
+        }
+    }
+    while (next_out < next_in)
+        failed |= !flush_chunk(&pool, reorder[next_out++ % pool.window]);
+    if (reader.error) {
+        fprintf(stderr, "Memory error\n");
+        failed = 1;
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    pool.shutdown = 1;
+    pthread_cond_broadcast(&pool.work_cv);
+    pthread_mutex_unlock(&pool.lock);
+    for (int i = 0; i < started; i++) {
+        pthread_join(tids[i], NULL);
+        stats->hits += workers[i].cache.hits;
+        stats->misses += workers[i].cache.misses;
+        stats->evictions += workers[i].cache.evictions;
+        ccal_cache_free(&workers[i].cache);
+        if (lat)
+            latency_merge(lat, workers[i].latency);
+    }
+    for (int i = 0; workers && i < threads; i++)
+        free(workers[i].latency);
+
+    for (int i = 0; pool.deques && i < threads; i++) {
+        if (pool.deques[i].items)
+            pthread_mutex_destroy(&pool.deques[i].lock);
+        free(pool.deques[i].items);
+    }
+    pthread_cond_destroy(&pool.done_cv);
+    pthread_cond_destroy(&pool.work_cv);
+    pthread_mutex_destroy(&pool.lock);
+    free(pool.deques);
+    free(reader.carry);
+    free(tids);
+    free(workers);
+    free(reorder);
+    return failed;
+}
+
+// Number of online processors, used for --threads 0.
+static int online_processors(void) {
+    #ifdef _SC_NPROCESSORS_ONLN
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+    #else
+    return 1;
+    #endif
+}
+
+// Map a regular file read-only. Returns the mapping, or NULL when the file
+// cannot be mapped and must be read as a stream instead.
+static const char* map_file(FILE* fp, size_t* len) {
+    #ifndef _WIN32
+    struct stat st;
+    int fd = fileno(fp);
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size <= 0)
+        return NULL;
+
+    void* map = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED)
+        return NULL;
+    #ifdef MADV_SEQUENTIAL
+    madvise(map, (size_t)st.st_size, MADV_SEQUENTIAL);
+    #endif
+    *len = (size_t)st.st_size;
+    return map;
+    #else
+    (void)fp;
+    (void)len;
+    return NULL;
+    #endif
+}
+
+// Release a mapping made by map_file.
+static void unmap_file(const char* map, size_t len) {
+    #ifndef _WIN32
+    munmap((void*)map, len);
+    #else
+    (void)map;
+    (void)len;
+    #endif
+}
+
+// Evaluate every line of a file ("-" or NULL for stdin) and print results.
+// Returns 0 if all lines evaluated, 1 if any line failed or input was unreadable.
+int run_batch(const BatchOptions* opts) {
+    FILE* fp = stdin;
+    if (opts->path && strcmp(opts->path, "-") != 0) {
+        fp = fopen(opts->path, "rb");
+        if (!fp) {
+            fprintf(stderr, "Error: Cannot open batch file: %s\n", opts->path);
+            return 1;
+        }
+    }
+
+    int threads = opts->threads == 0 ? online_processors() : opts->threads;
+    if (threads > BATCH_MAX_THREADS)
+        threads = BATCH_MAX_THREADS;
+
+    // Fully buffer results; one write per block instead of per line
+    setvbuf(stdout, NULL, _IOFBF, BATCH_OUT_BUF);
+
+    // Files are evaluated in place from a read-only mapping; pipes and
+    // terminals are read through stdio
+    size_t map_len = 0;
+    const char* map = map_file(fp, &map_len);
+
+    // Histograms are printed at the end and whenever SIGUSR1 arrives
+    latency_set* lat = NULL;
+    if (opts->latency) {
+        lat = latency_create();
+        if (!lat) {
+            fprintf(stderr, "Memory error\n");
+            if (map)
+                unmap_file(map, map_len);
+            if (fp != stdin)
+                fclose(fp);
+            return 1;
+        }
+        #ifdef SIGUSR1
+        signal(SIGUSR1, batch_signal);
+        #endif
+    }
+
+    // Each thread keeps its own cache, so lookups never take a lock
+    ccal_cache cache;
+    memset(&cache, 0, sizeof(cache));
+    int failed;
+    if (threads > 1)
+        failed = run_batch_parallel(fp, map, map_len, threads, opts->cache, &cache, lat);
+    else {
+        ccal_cache_init(&cache, opts->cache);
+        failed = map ? evaluate_buffer(map, map_len, &cache, lat)
+                     : run_batch_serial(fp, &cache, lat);
+    }
+
+    if (map)
+        unmap_file(map, map_len);
+    fflush(stdout);
+    if (opts->cache_stats)
+        fprintf(stderr, "Cache: %llu hits, %llu misses, %llu evictions\n",
+                cache.hits, cache.misses, cache.evictions);
+    if (lat) {
+        latency_print(stderr, lat);
+        free(lat);
+    }
+    ccal_cache_free(&cache);
+    if (fp != stdin)
+        fclose(fp);
+    return failed;
+}
+
+// COLUMNS MODE:
+//////////////////////////////////////////////////////////////////////////////
+
+// One block of CSV rows, stored column by column
+typedef struct {
+    const ccal_program* prog;
+    double* values;              // prog->columns arrays of CCAL_EXEC_BLOCK values
+    const double** cols;         // start of each column array
+    unsigned char* used;         // column is named by a placeholder
+    int decs[CCAL_EXEC_BLOCK];   // most decimals among a row's fields, -1 for none
+    unsigned char bad[CCAL_EXEC_BLOCK];  // row has a missing or non-numeric field
+    unsigned char err[CCAL_EXEC_BLOCK];  // row failed to evaluate
+    double out[CCAL_EXEC_BLOCK];
+    size_t rows;
+    int ok;
+} ColumnsBlock;
+
+// Take the next comma-separated field of [*p, end) into [*field, *field + *len),
+// without surrounding spaces or double quotes. Returns 0 when no field is left.
+static int next_field(const char** p, const char* end, const char** field, size_t* len) {
+    const char* s = *p;
+    if (!s)
+        return 0;
+    while (s < end && (*s == ' ' || *s == '\t'))
+        s++;
+
+    const char* f = s;
+    const char* e;
+    if (s < end && *s == '"') {
+        // quoted fields may hold thousands separators like "1,234.50"
+        f = ++s;
+        while (s < end && *s != '"')
+            s++;
+        e = s;
+        s = memchr(s, ',', end - s);
+    }
+    else {
+        s = memchr(s, ',', end - s);
+        e = s ? s : end;
+        while (e > f && (e[-1] == ' ' || e[-1] == '\t'))
+            e--;
+    }
+
+    *p = s ? s + 1 : NULL;
+    *field = f;
+    *len = e - f;
+    return 1;
+}
+
+// Parse the referenced fields of one CSV line into the next row of the block.
+static void columns_add_row(ColumnsBlock* blk, const char* line, size_t len) {
+    if (len > 0 && line[len - 1] == '\r')
+        len--;
+
+    size_t row = blk->rows++;
+    const char* p = line;
+    const char* end = line + len;
+    int dec = -1;
+    int bad = 0;
+    for (int c = 0; c < blk->prog->columns; c++) {
+        double* slot = blk->values + (size_t)c * CCAL_EXEC_BLOCK + row;
+        const char* field;
+        size_t field_len;
+        ccal_ctx ctx;
+        int error = 1;
+
+        if (!bad && next_field(&p, end, &field, &field_len)) {
+            if (!blk->used[c]) {
+                *slot = 0;  // columns skipped by the expression may hold text
+                continue;
+            }
+            ccal_ctx_init(&ctx);
+            *slot = ccal_parse_number(&ctx, field, field_len, &error);
+        }
+        if (error) {
+            *slot = 0;  // keep the block defined for the vector pass
+            bad = 1;
+            continue;
+        }
+        if (ctx.hasDec && ctx.maxDec > dec)
+            dec = ctx.maxDec;
+    }
+    blk->decs[row] = dec;
+    blk->bad[row] = (unsigned char)bad;
+}
+
+// Evaluate the rows of a block and write one result line per row.
+// Returns 0 if the evaluation could not run.
+static int columns_flush(ColumnsBlock* blk) {
+    const ccal_program* prog = blk->prog;
+    if (!ccal_exec_columns(prog, blk->cols, blk->rows, blk->out, blk->err))
+        return 0;
+
+    for (size_t i = 0; i < blk->rows; i++) {
+        if (blk->bad[i] || blk->err[i]) {
+            blk->ok = 0;
+            fputs(BATCH_ERROR_MARKER "\n", stdout);
+            continue;
+        }
+
+        // Decimals of the row's fields count as if they were typed into
+        // the expression in place of the placeholders
+        ccal_result res;
+        char out[BATCH_RESULT_LEN];
+        res.value = blk->out[i];
+        res.hasDec = prog->hasDec || blk->decs[i] >= 0;
+        res.maxDec = blk->decs[i] > prog->maxDec ? blk->decs[i] : prog->maxDec;
+        res.offDec = prog->offDec;
+        res.exact = 0;
+        size_t out_len = ccal_write_result(&res, 0, out);
+        out[out_len++] = '\n';
+        fwrite(out, 1, out_len, stdout);
+    }
+    blk->rows = 0;
+    return 1;
+}
+
+// Evaluate an expression over every row of a CSV file ("-" or NULL for stdin)
+// and print one result per row. Returns 0 if every row evaluated, 1 if any
+// row failed, the expression was invalid or input was unreadable.
+int run_columns(const ColumnsOptions* opts) {
+    ccal_ctx ctx;
+    ccal_program prog;
+    ccal_ctx_init(&ctx);
+    ctx.columns = 1;
+    int compiled = ccal_compile(&ctx, opts->expr, &prog);
+    ccal_ctx_free(&ctx);
+    if (!compiled) {
+        fprintf(stderr, "Error: Invalid expression\n");
+        return 1;
+    }
+
+    FILE* fp = stdin;
+    if (opts->path && strcmp(opts->path, "-") != 0) {
+        fp = fopen(opts->path, "rb");
+        if (!fp) {
+            fprintf(stderr, "Error: Cannot open columns file: %s\n", opts->path);
+            ccal_program_free(&prog);
+            return 1;
+        }
+    }
+
+    ColumnsBlock* blk = calloc(1, sizeof(ColumnsBlock));
+    size_t ncols = prog.columns > 0 ? (size_t)prog.columns : 1;
+    if (blk) {
+        blk->values = malloc(ncols * CCAL_EXEC_BLOCK * sizeof(double));
+        blk->cols = malloc(ncols * sizeof(double*));
+        blk->used = calloc(ncols, 1);
+    }
+    if (!blk || !blk->values || !blk->cols || !blk->used) {
+        fprintf(stderr, "Memory error\n");
+        if (blk) {
+            free(blk->values);
+            free(blk->cols);
+            free(blk->used);
+            free(blk);
+        }
+        ccal_program_free(&prog);
+        if (fp != stdin)
+            fclose(fp);
+        return 1;
+    }
+    blk->prog = &prog;
+    blk->ok = 1;
+    for (size_t c = 0; c < ncols; c++)
+        blk->cols[c] = blk->values + c * CCAL_EXEC_BLOCK;
+    for (int i = 0; i < prog.code_len; i++) {
+        if (prog.code[i].op == CCAL_OP_COL)
+            blk->used[prog.code[i].arg] = 1;
+    }
+
+    setvbuf(stdout, NULL, _IOFBF, BATCH_OUT_BUF);
+
+    size_t map_len = 0;
+    const char* map = map_file(fp, &map_len);
+    int fatal = 0;
+    if (map) {
+        const char* p = map;
+        const char* end = map + map_len;
+        while (p < end && !fatal) {
+            const char* nl = memchr(p, '\n', end - p);
+            const char* line_end = nl ? nl : end;
+            columns_add_row(blk, p, line_end - p);
+            if (blk->rows == CCAL_EXEC_BLOCK)
+                fatal = !columns_flush(blk);
+            p = line_end + 1;
+        }
+        unmap_file(map, map_len);
+    }
+    else {
+        char* line = malloc(BATCH_LINE_LEN);
+        size_t cap = BATCH_LINE_LEN;
+        long len;
+        fatal = !line;
+        while (!fatal && (len = read_line(fp, &line, &cap)) >= 0) {
+            columns_add_row(blk, line, (size_t)len);
+            if (blk->rows == CCAL_EXEC_BLOCK)
+                fatal = !columns_flush(blk);
+        }
+        free(line);
+    }
+    if (!fatal && blk->rows > 0)
+        fatal = !columns_flush(blk);
+    fflush(stdout);
+    if (fatal)
+        fprintf(stderr, "Memory error\n");
+
+    int failed = fatal || !blk->ok;
+    free(blk->values);
+    free(blk->cols);
+    free(blk->used);
+    free(blk);
+    ccal_program_free(&prog);
+    if (fp != stdin)
+        fclose(fp);
+    return failed;
+}
@@ -0,0 +1,36 @@
+// modules/batch.h
+// Header file for batch evaluation module
+// Declares functions for evaluating one expression per line from a file or stdin,
+// or one expression over every row of a CSV file
+
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stddef.h>
+
+// Marker written in place of a result when a line fails to evaluate
+#define BATCH_ERROR_MARKER "Error: Invalid expression"
+
+// Result cache size in KiB when --cache-stats is given without --cache
+#define BATCH_CACHE_DEFAULT_KIB 1024
+
+// Options for a batch run
+typedef struct {
+    const char* path;  // input file, "-" or NULL for stdin
+    int threads;       // worker threads; 1 evaluates inline, 0 uses every core
+    size_t cache;      // bytes of result cache, split across threads; 0 for none
+    int cache_stats;   // print cache hits and misses to stderr at the end
+    int latency;       // print latency histograms to stderr at the end and on SIGUSR1
+} BatchOptions;
+
+// Options for a columns run
+typedef struct {
+    const char* expr;  // expression using $1, $2, ... for the row's columns
+    const char* path;  // CSV file, "-" or NULL for stdin
+} ColumnsOptions;
+
+// Function declarations
+int run_batch(const BatchOptions* opts);
+int run_columns(const ColumnsOptions* opts);
+
+#endif // BATCH_H
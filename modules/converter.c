@@ -14,6 +14,29 @@
 #include <dirent.h>
 #endif
 
+#include "../ccal.h"
+#include "../trace.h"
+
+// The standalone converter has no ccal.c to hold the trace counters
+#if defined(CCAL_TRACE) && defined(CONVERTER_STANDALONE)
+_Atomic unsigned long long ccal_trace_counts[CCAL_TRACE_COUNTERS];
+_Atomic int ccal_trace_max_depth;
+#endif
+
+#ifdef CCAL_SDT
+// Semaphores of the converter's USDT probes (see trace.h).
+CCAL_PROBE_DEFINE(rules__load);
+CCAL_PROBE_DEFINE(convert);
+#endif
+
+// Diagnostics go to stderr for the command line; the library build stays
+// silent and callers get status codes instead
+#ifdef CCAL_LIBRARY
+#define converter_error(...) ((void)0)
+#else
+#define converter_error(...) fprintf(stderr, __VA_ARGS__)
+#endif
+
 // Include embedded rule data
 #ifdef USE_EMBEDDED_RULES
 #include "rules.h"  // Master header that includes all rule files
@@ -41,6 +64,11 @@ typedef struct {
     int unit_count;                        // Number of units defined
 } ConversionRules;
 
+// Wrapper behind the opaque ccal_rules handle of ccal.h
+struct ccal_rules {
+    ConversionRules rules;
+};
+
 // Trim whitespace from both ends of a string
 void trim_whitespace(char* str) {
     char* start = str;
@@ -147,6 +175,7 @@ int parse_unit_offset_array(const char* line, double* offset_array, int* count)
             }
         } else if ((*p == ',' || *p == ']') && buf_idx > 0) {
             buffer[buf_idx] = '\0';
+            CCAL_TRACE_HIT(CCAL_TRACE_STRTOD);
             offset_array[*count] = atof(buffer);
             (*count)++;
             buf_idx = 0;
@@ -178,6 +207,7 @@ int parse_unit_to_array(const char* line, double* to_array, int* count) {
             }
         } else if ((*p == ',' || *p == ']') && buf_idx > 0) {
             buffer[buf_idx] = '\0';
+            CCAL_TRACE_HIT(CCAL_TRACE_STRTOD);
             to_array[*count] = atof(buffer);
             (*count)++;
             buf_idx = 0;
@@ -191,9 +221,11 @@ int parse_unit_to_array(const char* line, double* to_array, int* count) {
 
 // Load conversion rules from a JSON file
 int load_conversion_rules(const char* filepath, ConversionRules* rules) {
+    CCAL_PROBE_CLOCK(probe_start, rules__load);
     FILE* fp = fopen(filepath, "r");
     if (!fp) {
-        fprintf(stderr, "Error: Cannot open rules file: %s\n", filepath);
+        converter_error("Error: Cannot open rules file: %s\n", filepath);
+        CCAL_PROBE4(rules__load, filepath, 0, 0, CCAL_PROBE_ELAPSED(probe_start));
         return 0;
     }
     
@@ -205,6 +237,7 @@ int load_conversion_rules(const char* filepath, ConversionRules* rules) {
     int current_unit_has_offset = 0;
     
     while (fgets(line, sizeof(line), fp)) {
+        CCAL_TRACE_HIT(CCAL_TRACE_RULE_LINE);
         trim_whitespace(line);
         
         // Parse converter array
@@ -255,12 +288,15 @@ int load_conversion_rules(const char* filepath, ConversionRules* rules) {
     }
     
     fclose(fp);
+    CCAL_PROBE4(rules__load, filepath, rules->unit_count, rules->unit_count > 0,
+                CCAL_PROBE_ELAPSED(probe_start));
     return rules->unit_count > 0;
 }
 
 // Load conversion rules from embedded data (compiled-in JSON)
 #ifdef USE_EMBEDDED_RULES
 int load_embedded_conversion_rules(const char* rule_name, ConversionRules* rules) {
+    CCAL_PROBE_CLOCK(probe_start, rules__load);
     unsigned char* json_data = NULL;
     unsigned int json_len = 0;
     
@@ -272,7 +308,8 @@ int load_embedded_conversion_rules(const char* rule_name, ConversionRules* rules
         json_data = rules_converter_temperature_json;
         json_len = rules_converter_temperature_json_len;
     } else {
-        fprintf(stderr, "Error: Unknown embedded rule: %s\n", rule_name);
+        converter_error("Error: Unknown embedded rule: %s\n", rule_name);
+        CCAL_PROBE4(rules__load, rule_name, 0, 0, CCAL_PROBE_ELAPSED(probe_start));
         return 0;
     }
     
@@ -293,6 +330,7 @@ int load_embedded_conversion_rules(const char* rule_name, ConversionRules* rules
         }
         line[line_idx] = '\0';
         if (pos < json_len && json_data[pos] == '\n') pos++;  // Skip newline
+        CCAL_TRACE_HIT(CCAL_TRACE_RULE_LINE);
         
         trim_whitespace(line);
         
@@ -342,26 +380,61 @@ int load_embedded_conversion_rules(const char* rule_name, ConversionRules* rules
         }
     }
     
+    CCAL_PROBE4(rules__load, rule_name, rules->unit_count, rules->unit_count > 0,
+                CCAL_PROBE_ELAPSED(probe_start));
     return rules->unit_count > 0;
 }
 #endif
 
+// Find the next alias in a comma-separated name list, starting at *pos
+// and skipping empty fields like strtok. Whitespace around the alias is
+// excluded. Returns its length, or -1 when the list is exhausted.
+// Unlike strtok this keeps no hidden state, so lookups may run on
+// several threads at once.
+static int next_unit_alias(const char* names, size_t* pos, const char** alias) {
+    CCAL_TRACE_HIT(CCAL_TRACE_ALIAS);
+    const char* p = names + *pos;
+    while (*p == ',') p++;
+    if (*p == '\0') {
+        return -1;
+    }
+    
+    const char* end = p;
+    while (*end && *end != ',') end++;
+    *pos = (size_t)(end - names);
+    
+    while (p < end && isspace((unsigned char)*p)) p++;
+    while (end > p && isspace((unsigned char)end[-1])) end--;
+    *alias = p;
+    return (int)(end - p);
+}
+
 // Find a unit by name (case-insensitive, checks all aliases)
 int find_unit_by_name(const ConversionRules* rules, const char* name) {
+    CCAL_TRACE_HIT(CCAL_TRACE_FIND_UNIT);
+    size_t name_len = strlen(name);
     for (int i = 0; i < rules->unit_count; i++) {
-        char names_copy[MAX_NAME_LEN];
-        strcpy(names_copy, rules->units[i].names);
+        const char* alias;
+        size_t pos = 0;
+        int len;
         
         // Check each comma-separated name
-        char* token = strtok(names_copy, ",");
-        while (token) {
-            trim_whitespace(token);
-            
+        while ((len = next_unit_alias(rules->units[i].names, &pos, &alias)) >= 0) {
             // Case-insensitive comparison
-            if (strcasecmp(token, name) == 0) {
+            if ((size_t)len == name_len && strncasecmp(alias, name, name_len) == 0) {
                 return i;
             }
-            token = strtok(NULL, ",");
+        }
+    }
+    return -1;
+}
+
+// Find a target unit in the converter array (case-insensitive)
+int find_target_unit(const ConversionRules* rules, const char* name) {
+    CCAL_TRACE_HIT(CCAL_TRACE_FIND_TARGET);
+    for (int i = 0; i < rules->converter_count; i++) {
+        if (strcasecmp(rules->converter_units[i], name) == 0) {
+            return i;
         }
     }
     return -1;
@@ -379,15 +452,7 @@ const char* auto_detect_rule(const char* from_unit, const char* to_unit) {
         ConversionRules test_rules;
         if (load_embedded_conversion_rules(rule_names[r], &test_rules)) {
             int from_found = (find_unit_by_name(&test_rules, from_unit) >= 0);
-            int to_found = 0;
-            
-            // Check if to_unit is in converter array
-            for (int i = 0; i < test_rules.converter_count; i++) {
-                if (strcasecmp(test_rules.converter_units[i], to_unit) == 0) {
-                    to_found = 1;
-                    break;
-                }
-            }
+            int to_found = (find_target_unit(&test_rules, to_unit) >= 0);
             
             if (from_found && to_found) {
                 return rule_names[r];
@@ -399,31 +464,26 @@ const char* auto_detect_rule(const char* from_unit, const char* to_unit) {
 }
 #endif
 
-// Convert a value from one unit to another
-double convert_unit(const ConversionRules* rules, double value, 
-                   const char* from_unit, const char* to_unit) {
+// Convert a value from one unit to another, setting *ok to 0 on failure
+static double apply_conversion(const ConversionRules* rules, double value,
+                               const char* from_unit, const char* to_unit, int* ok) {
+    *ok = 0;
     int from_idx = find_unit_by_name(rules, from_unit);
     if (from_idx < 0) {
-        fprintf(stderr, "Error: Unknown unit '%s'\n", from_unit);
+        converter_error("Error: Unknown unit '%s'\n", from_unit);
         return 0;
     }
     
     // Find the target unit in the converter array
-    int to_idx = -1;
-    for (int i = 0; i < rules->converter_count; i++) {
-        if (strcasecmp(rules->converter_units[i], to_unit) == 0) {
-            to_idx = i;
-            break;
-        }
-    }
+    int to_idx = find_target_unit(rules, to_unit);
     
     if (to_idx < 0) {
-        fprintf(stderr, "Error: Unknown target unit '%s'\n", to_unit);
+        converter_error("Error: Unknown target unit '%s'\n", to_unit);
         return 0;
     }
     
     if (to_idx >= rules->units[from_idx].to_count) {
-        fprintf(stderr, "Error: Conversion not defined\n");
+        converter_error("Error: Conversion not defined\n");
         return 0;
     }
     
@@ -433,9 +493,23 @@ double convert_unit(const ConversionRules* rules, double value,
         result += rules->units[from_idx].offset[to_idx];
     }
     
+    *ok = 1;
     return result;
 }
 
+// Convert a value from one unit to another
+double convert_unit(const ConversionRules* rules, double value, 
+                   const char* from_unit, const char* to_unit) {
+    CCAL_TRACE_HIT(CCAL_TRACE_CONVERT);
+    CCAL_PROBE_CLOCK(probe_start, convert);
+    int ok;
+    double result = apply_conversion(rules, value, from_unit, to_unit, &ok);
+    CCAL_PROBE5(convert, from_unit, to_unit, ccal_probe_bits(result), ok,
+                CCAL_PROBE_ELAPSED(probe_start));
+    return result;
+}
+
+#ifndef CCAL_LIBRARY
 // Print available units for a given rule set
 void print_available_units(const ConversionRules* rules) {
     printf("Available units:\n");
@@ -443,6 +517,7 @@ void print_available_units(const ConversionRules* rules) {
         printf("  %s\n", rules->units[i].names);
     }
 }
+#endif
 
 // Get the short name (first name in the list) for display
 void get_unit_short_name(const ConversionRules* rules, int unit_idx, char* buffer) {
@@ -451,18 +526,18 @@ void get_unit_short_name(const ConversionRules* rules, int unit_idx, char* buffe
         return;
     }
     
-    char names_copy[MAX_NAME_LEN];
-    strcpy(names_copy, rules->units[unit_idx].names);
-    
-    char* first_name = strtok(names_copy, ",");
-    if (first_name) {
-        trim_whitespace(first_name);
-        strcpy(buffer, first_name);
+    const char* first_name;
+    size_t pos = 0;
+    int len = next_unit_alias(rules->units[unit_idx].names, &pos, &first_name);
+    if (len >= 0) {
+        memcpy(buffer, first_name, (size_t)len);
+        buffer[len] = '\0';
     } else {
         strcpy(buffer, "unknown");
     }
 }
 
+#ifndef CCAL_LIBRARY
 // Convert and display results to all units
 void convert_and_display_all(const ConversionRules* rules, double value, 
                              const char* from_unit) {
@@ -485,6 +560,7 @@ void convert_and_display_all(const ConversionRules* rules, double value,
         printf("  %-12s : %.6f\n", rules->converter_units[i], result);
     }
 }
+#endif
 
 // Count JSON files in rules/converter directory
 int count_rule_files(char* single_rule_name) {
@@ -538,6 +614,98 @@ int count_rule_files(char* single_rule_name) {
     #endif
 }
 
+// LIBRARY INTERFACE:
+// Status-returning wrappers declared in ccal.h; none of them prints anything
+
+// Load the named rule set the way ccal -m converter does: compiled in with
+// USE_EMBEDDED_RULES, otherwise from rules/converter/<name>.json.
+// Returns NULL if it cannot be loaded.
+ccal_rules* ccal_rules_load(const char* name) {
+    // Rule names become file names, so only plain words are accepted
+    size_t len = strlen(name);
+    if (len == 0 || len > MAX_NAME_LEN) {
+        return NULL;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (!isalnum((unsigned char)name[i]) && name[i] != '_' && name[i] != '-') {
+            return NULL;
+        }
+    }
+    
+    #ifdef USE_EMBEDDED_RULES
+    ccal_rules* rules = malloc(sizeof(ccal_rules));
+    if (rules && !load_embedded_conversion_rules(name, &rules->rules)) {
+        free(rules);
+        return NULL;
+    }
+    return rules;
+    #else
+    char rule_path[256];
+    snprintf(rule_path, sizeof(rule_path), "rules/converter/%s.json", name);
+    return ccal_rules_load_file(rule_path);
+    #endif
+}
+
+// Load a rule set from a JSON file. Returns NULL if it cannot be read or
+// defines no units.
+ccal_rules* ccal_rules_load_file(const char* path) {
+    ccal_rules* rules = malloc(sizeof(ccal_rules));
+    if (rules && !load_conversion_rules(path, &rules->rules)) {
+        free(rules);
+        return NULL;
+    }
+    return rules;
+}
+
+// Name of the embedded rule set that converts from_unit to to_unit, or
+// NULL if none does. Builds reading rule files always return NULL, since
+// the command line requires the rule name there too.
+const char* ccal_rules_detect(const char* from_unit, const char* to_unit) {
+    #ifdef USE_EMBEDDED_RULES
+    return auto_detect_rule(from_unit, to_unit);
+    #else
+    (void)from_unit;
+    (void)to_unit;
+    return NULL;
+    #endif
+}
+
+void ccal_rules_free(ccal_rules* rules) {
+    free(rules);
+}
+
+// Convert value from from_unit to to_unit, storing it in *result.
+// Returns CCAL_CONVERT_OK or the reason the conversion is not possible.
+int ccal_convert(const ccal_rules* rules, double value, const char* from_unit,
+                 const char* to_unit, double* result) {
+    int from_idx = find_unit_by_name(&rules->rules, from_unit);
+    if (from_idx < 0) {
+        return CCAL_CONVERT_UNKNOWN_FROM;
+    }
+    int to_idx = find_target_unit(&rules->rules, to_unit);
+    if (to_idx < 0) {
+        return CCAL_CONVERT_UNKNOWN_TO;
+    }
+    if (to_idx >= rules->rules.units[from_idx].to_count) {
+        return CCAL_CONVERT_UNDEFINED;
+    }
+    *result = convert_unit(&rules->rules, value, from_unit, to_unit);
+    return CCAL_CONVERT_OK;
+}
+
+// Store the display name of unit, the first of its aliases, in buf, cut
+// short if cap is too small. Returns 1, or 0 for an unknown unit.
+int ccal_unit_short_name(const ccal_rules* rules, const char* unit, char* buf, size_t cap) {
+    int idx = find_unit_by_name(&rules->rules, unit);
+    if (idx < 0 || cap == 0) {
+        return 0;
+    }
+    char name[MAX_NAME_LEN];
+    get_unit_short_name(&rules->rules, idx, name);
+    snprintf(buf, cap, "%s", name);
+    return 1;
+}
+
 // Example usage demonstration (can be removed when integrating with main)
 #ifdef CONVERTER_STANDALONE
 int main(int argc, char* argv[]) {
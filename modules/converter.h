@@ -38,6 +38,7 @@ int load_embedded_conversion_rules(const char* rule_name, ConversionRules* rules
 const char* auto_detect_rule(const char* from_unit, const char* to_unit);
 #endif
 int find_unit_by_name(const ConversionRules* rules, const char* name);
+int find_target_unit(const ConversionRules* rules, const char* name);
 double convert_unit(const ConversionRules* rules, double value, const char* from_unit, const char* to_unit);
 void print_available_units(const ConversionRules* rules);
 void get_unit_short_name(const ConversionRules* rules, int unit_idx, char* buffer);
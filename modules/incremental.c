@@ -0,0 +1,485 @@
+// modules/incremental.c
+// Incremental evaluation for ccal calculator
+// Keeps the tokens of one expression and the partial results of every
+// bracket group between edits. An edit re-lexes from the first token whose
+// lexing read the changed text until the new tokens line up with the old
+// ones again. Evaluation folds each group left to right from the last + or
+// - before the change, taking every unchanged bracket group and every
+// unchanged term after a + or - from its cache
+// Needs nothing but ccal.c, so it can be tested and timed without a GUI
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "../ccal.h"
+#include "incremental.h"
+
+// Smallest text, token and frame allocations
+#define INCR_INITIAL 64
+
+// Set up an empty expression, which evaluates to an error.
+void ccal_incr_init(ccal_incr* inc) {
+    memset(inc, 0, sizeof(*inc));
+    inc->max_depth = CCAL_MAX_DEPTH;
+    inc->stale = 1;
+}
+
+// Release everything the expression holds.
+void ccal_incr_free(ccal_incr* inc) {
+    free(inc->text);
+    free(inc->tokens);
+    free(inc->frames);
+    memset(inc, 0, sizeof(*inc));
+}
+
+// Grow an array of *cap elements of size bytes to hold need of them.
+// Returns 0 if memory runs out.
+static int grow_array(void** arr, int* cap, int need, size_t size) {
+    if (need <= *cap)
+        return 1;
+    int grown_cap = *cap ? *cap : INCR_INITIAL;
+    while (grown_cap < need)
+        grown_cap *= 2;
+    void* grown = realloc(*arr, (size_t)grown_cap * size);
+    if (!grown)
+        return 0;
+    *arr = grown;
+    *cap = grown_cap;
+    return 1;
+}
+
+// Token i, counting the tokens before the gap and then those after it.
+static ccal_incr_token* token_at(const ccal_incr* inc, int i) {
+    return &inc->tokens[i < inc->gap ? i : i + (inc->token_cap - inc->count)];
+}
+
+// Switch a token's offsets between counting from the start of the text and
+// counting from its end; the same subtraction works both ways.
+static void flip_offsets(ccal_incr_token* t, size_t len) {
+    t->tok.start = len - t->tok.start;
+    t->tok.look = len - t->tok.look;
+    t->reach = len - t->reach;
+}
+
+// Reach of token i from the start of the text, wherever it is stored.
+static size_t token_reach(const ccal_incr* inc, int i) {
+    const ccal_incr_token* t = token_at(inc, i);
+    return i < inc->gap ? t->reach : inc->len - t->reach;
+}
+
+// Move the gap in front of token g.
+static void move_gap(ccal_incr* inc, int g) {
+    int spare = inc->token_cap - inc->count;
+    if (g < inc->gap) {
+        memmove(&inc->tokens[g + spare], &inc->tokens[g],
+                (size_t)(inc->gap - g) * sizeof(ccal_incr_token));
+        for (int i = g; i < inc->gap; i++)
+            flip_offsets(&inc->tokens[i + spare], inc->len);
+    }
+    else if (g > inc->gap) {
+        memmove(&inc->tokens[inc->gap], &inc->tokens[inc->gap + spare],
+                (size_t)(g - inc->gap) * sizeof(ccal_incr_token));
+        for (int i = inc->gap; i < g; i++)
+            flip_offsets(&inc->tokens[i], inc->len);
+    }
+    inc->gap = g;
+}
+
+// Lex the token at pos into *t, forgetting what evaluation remembered.
+// Returns the position after the token.
+static size_t lex_token(const ccal_incr* inc, size_t pos, int operand, ccal_incr_token* t) {
+    size_t next = ccal_next_token(inc->text, inc->len, pos, operand, &t->tok);
+    t->operand = operand;
+    t->owner = 0;
+    t->span = 0;
+    t->cached = 0;
+    return next;
+}
+
+// Whether the token after t is read in operand position.
+static int operand_after(const ccal_incr_token* t) {
+    switch (t->tok.kind) {
+    case CCAL_TOK_NUMBER:
+    case CCAL_TOK_CLOSE:
+        return 0;
+    case CCAL_TOK_BAD:
+        return t->operand;
+    default:
+        return 1;
+    }
+}
+
+// Whether a relexed token is the old token o, moved by the edit.
+static int same_token(const ccal_incr_token* t, const ccal_incr_token* o) {
+    return t->tok.kind == o->tok.kind && t->tok.op == o->tok.op &&
+           t->tok.len == o->tok.len && t->operand == o->operand;
+}
+
+// Forget every token after running out of memory; the next edit lexes the
+// whole text again.
+static int drop_tokens(ccal_incr* inc) {
+    inc->count = 0;
+    inc->gap = 0;
+    inc->stale = 1;
+    inc->damage_lo = 0;
+    inc->damage_hi = 0;
+    return 0;
+}
+
+// Replace del bytes at pos with ins_len bytes of ins and bring the tokens up
+// to date. Returns 0 if memory runs out.
+int ccal_incr_edit(ccal_incr* inc, size_t pos, size_t del, const char* ins, size_t ins_len) {
+    if (pos > inc->len)
+        pos = inc->len;
+    if (del > inc->len - pos)
+        del = inc->len - pos;
+    size_t len = inc->len - del + ins_len;
+    if (len + 1 > inc->cap) {
+        size_t cap = inc->cap ? inc->cap : INCR_INITIAL;
+        while (cap < len + 1)
+            cap *= 2;
+        char* grown = realloc(inc->text, cap);
+        if (!grown)
+            return 0;
+        inc->text = grown;
+        inc->cap = cap;
+    }
+
+    // First token whose lexing read text at or after pos; reach never
+    // decreases, so it can be found by bisection
+    int a = 0, b = inc->count;
+    while (a < b) {
+        int mid = a + (b - a) / 2;
+        if (token_reach(inc, mid) > pos)
+            b = mid;
+        else
+            a = mid + 1;
+    }
+    move_gap(inc, a);
+
+    // Splice the text; tokens after the gap count from its end, so they
+    // stay put
+    memmove(inc->text + pos + ins_len, inc->text + pos + del, inc->len - pos - del);
+    memcpy(inc->text + pos, ins, ins_len);
+    inc->len = len;
+    inc->text[len] = '\0';
+
+    // Lex from the end of the last untouched token into the gap until a
+    // token matches an old one past the edit
+    const ccal_incr_token* prev = a > 0 ? token_at(inc, a - 1) : NULL;
+    size_t p = prev ? prev->tok.start + prev->tok.len : 0;
+    int operand = prev ? operand_after(prev) : 1;
+    int spare = inc->token_cap - inc->count;
+    int j = a;  // first old token not yet passed
+    int n = 0;
+    for (;;) {
+        ccal_incr_token t;
+        size_t next = lex_token(inc, p, operand, &t);
+        if (t.tok.kind == CCAL_TOK_END) {
+            j = inc->count;
+            break;
+        }
+        const ccal_incr_token* old = NULL;
+        while (j < inc->count) {
+            old = &inc->tokens[j + spare];
+            size_t start = len - old->tok.start;
+            if (start >= pos + ins_len && start >= t.tok.start)
+                break;
+            j++;
+        }
+        if (j < inc->count && len - old->tok.start == t.tok.start && same_token(&t, old))
+            break;
+
+        if (a + n == j + spare) {
+            // Gap full: grow the array and move the old tokens to its end
+            int old_cap = inc->token_cap;
+            int after = inc->count - a;
+            if (!grow_array((void**)&inc->tokens, &inc->token_cap, inc->count + n + 1,
+                            sizeof(ccal_incr_token)))
+                return drop_tokens(inc);
+            memmove(&inc->tokens[inc->token_cap - after], &inc->tokens[old_cap - after],
+                    (size_t)after * sizeof(ccal_incr_token));
+            spare = inc->token_cap - inc->count;
+        }
+        inc->tokens[a + n++] = t;
+        operand = operand_after(&t);
+        p = next;
+    }
+    inc->lexed = n;
+
+    // The old tokens [a, j) are now part of the gap
+    int removed = j - a;
+    inc->count += n - removed;
+    inc->gap = a + n;
+
+    // Carry reach forward until it agrees with what the old tokens had
+    size_t reach = a > 0 ? token_reach(inc, a - 1) : 0;
+    for (int i = a; i < inc->count; i++) {
+        ccal_incr_token* t = token_at(inc, i);
+        if (i < inc->gap) {
+            reach = t->tok.look > reach ? t->tok.look : reach;
+            t->reach = reach;
+            continue;
+        }
+        size_t look = len - t->tok.look;
+        reach = look > reach ? look : reach;
+        if (len - t->reach == reach)
+            break;
+        t->reach = len - reach;
+    }
+
+    // Widen the damage since the last evaluation to cover the new tokens
+    if (n == 0 && removed == 0)
+        return 1;  // only spacing changed
+    if (inc->stale) {
+        int lo = inc->damage_lo, hi = inc->damage_hi;
+        lo = lo < a ? lo : lo >= j ? lo - removed + n : a;
+        hi = hi <= a ? hi : hi >= j ? hi - removed + n : a + n;
+        inc->damage_lo = lo < a ? lo : a;
+        inc->damage_hi = hi > a + n ? hi : a + n;
+    }
+    else {
+        inc->damage_lo = a;
+        inc->damage_hi = a + n;
+    }
+    inc->stale = 1;
+    return 1;
+}
+
+// Replace the whole text. Returns 0 if memory runs out.
+int ccal_incr_set(ccal_incr* inc, const char* text, size_t len) {
+    return ccal_incr_edit(inc, 0, inc->len, text, len);
+}
+
+// Merge the precision, nesting and errors of part b into part a.
+static void merge_part(ccal_incr_part* a, const ccal_incr_part* b) {
+    if (b->has_dec)
+        a->has_dec = 1;
+    if (b->max_dec > a->max_dec)
+        a->max_dec = b->max_dec;
+    if (b->depth > a->depth)
+        a->depth = b->depth;
+    if (b->error)
+        a->error = 1;
+}
+
+// Fold an operand into the current term after the unary minuses waiting
+// for it. part holds its value with the precision and errors behind it and
+// its nesting below the operand itself. Like the parser, nothing more is
+// computed once the term is invalid.
+static void fold_operand(ccal_incr_frame* fr, const ccal_incr_part* part) {
+    ccal_num v = part->value;
+    ccal_incr_part* cur = &fr->cur;
+    merge_part(cur, part);
+    if (part->depth + fr->negs > cur->depth)
+        cur->depth = part->depth + fr->negs;
+    for (; fr->negs > 0; fr->negs--)
+        ccal_apply(CCAL_OP_NEG, &v, NULL);
+
+    if (!fr->any)
+        cur->value = v;
+    else if (!cur->error && !ccal_apply(fr->op, &cur->value, &v))
+        cur->error = 1;
+    fr->any = 1;
+    fr->op = 0;
+}
+
+// End the current term, whose last token is last: remember it for the + or
+// - before it and join it to the terms before.
+static void end_term(ccal_incr* inc, ccal_incr_frame* fr, int last) {
+    if (!fr->any || fr->op || fr->negs)
+        fr->cur.error = 1;  // an operator with no operand after it
+    if (fr->term >= 0) {
+        ccal_incr_token* t = token_at(inc, fr->term);
+        t->part = fr->cur;
+        t->span = last - fr->term;
+        t->cached = 1;
+    }
+
+    ccal_incr_part* sum = &fr->sum;
+    merge_part(sum, &fr->cur);
+    if (!fr->sum_op)
+        sum->value = fr->cur.value;
+    else if (!sum->error)
+        ccal_apply(fr->sum_op, &sum->value, &fr->cur.value);
+}
+
+// Whether op joins terms rather than the operands of a term.
+static int is_term_op(int op) {
+    return op == CCAL_OP_ADD || op == CCAL_OP_SUB;
+}
+
+// Last + or - of the group opened at token open that lies before token lo,
+// or -1 if there is none. Nested groups are stepped over whole.
+static int resume_point(const ccal_incr* inc, int open, int lo) {
+    int i = lo - 1;
+    while (i > open) {
+        const ccal_incr_token* t = token_at(inc, i);
+        if (t->tok.kind == CCAL_TOK_CLOSE && t->span > 0) {
+            i -= t->span + 1;
+            continue;
+        }
+        if (t->tok.kind == CCAL_TOK_OP && is_term_op(t->tok.op) && t->owner > 0 &&
+            i - t->owner == open)
+            return i;
+        i--;
+    }
+    return -1;
+}
+
+// Start folding the group opened at token open on top of the frame stack,
+// after its last + or - before the damage when there is one. Returns the
+// token to continue at, or -1 if memory runs out.
+static int push_group(ccal_incr* inc, int* frames, int open) {
+    if (!grow_array((void**)&inc->frames, &inc->frame_cap, *frames + 1, sizeof(ccal_incr_frame)))
+        return -1;
+    ccal_incr_frame* fr = &inc->frames[(*frames)++];
+    memset(fr, 0, sizeof(*fr));
+    fr->open = open;
+    fr->term = -1;
+
+    int r = open < inc->damage_lo ? resume_point(inc, open, inc->damage_lo) : -1;
+    if (r < 0)
+        return open + 1;
+    const ccal_incr_token* t = token_at(inc, r);
+    fr->sum = t->before;
+    fr->sum_op = t->tok.op;
+    fr->term = r;
+    return r + 1;
+}
+
+// Close the group on top of the frame stack, whose last token is last, and
+// fold its result into the group around it. A span of 0 leaves it unclosed.
+static void pop_group(ccal_incr* inc, int* frames, int last, int span) {
+    ccal_incr_frame* fr = &inc->frames[--*frames];
+    end_term(inc, fr, last);
+    ccal_incr_token* open = token_at(inc, fr->open);
+    open->part = fr->sum;
+    open->span = span;
+    open->cached = 1;
+    if (!span || open->tok.op != token_at(inc, last + 1)->tok.op)
+        open->part.error = 1;  // never closed, or closed by the wrong bracket
+    ccal_incr_part group = open->part;
+    group.depth++;
+    fold_operand(&inc->frames[*frames - 1], &group);
+}
+
+// Fold the tokens the damage affects, leaving the result in inc->res.
+// Returns 0 if memory ran out, reporting an error for now.
+static int evaluate(ccal_incr* inc) {
+    int lo = inc->damage_lo, hi = inc->damage_hi;
+    int frames = 0;
+    size_t folded = 0;
+    int i = push_group(inc, &frames, -1);
+
+    while (i >= 0 && i < inc->count) {
+        ccal_incr_frame* fr = &inc->frames[frames - 1];
+        ccal_incr_token* t = token_at(inc, i);
+        folded++;
+        switch (t->tok.kind) {
+        case CCAL_TOK_NUMBER: {
+            ccal_incr_part num = { t->tok.num, t->tok.decimals >= 0,
+                                   t->tok.decimals > 0 ? t->tok.decimals : 0, 0, 0 };
+            fold_operand(fr, &num);
+            i++;
+            break;
+        }
+        case CCAL_TOK_NEG:
+            fr->negs++;
+            i++;
+            break;
+        case CCAL_TOK_OP:
+            if (!is_term_op(t->tok.op)) {
+                fr->op = t->tok.op;
+                i++;
+                break;
+            }
+            end_term(inc, fr, i - 1);
+            fr->sum_op = t->tok.op;
+            fr->term = i;
+            fr->any = 0;
+            memset(&fr->cur, 0, sizeof(fr->cur));
+            t->before = fr->sum;
+            t->owner = i - fr->open;
+            if (t->cached && i >= hi) {
+                // The term after it is unchanged
+                fr->cur = t->part;
+                fr->any = 1;
+                i += t->span;
+            }
+            i++;
+            break;
+        case CCAL_TOK_OPEN:
+            if (t->cached && (i >= hi || (t->span && i + t->span < lo))) {
+                // An unchanged group
+                ccal_incr_part group = t->part;
+                group.depth++;
+                fold_operand(fr, &group);
+                i = t->span ? i + t->span + 1 : inc->count;
+            }
+            else {
+                i = push_group(inc, &frames, i);
+            }
+            break;
+        case CCAL_TOK_CLOSE:
+            if (frames > 1) {
+                t->span = i - fr->open;
+                pop_group(inc, &frames, i - 1, t->span);
+            }
+            else {
+                // Close bracket with nothing open. It would end the term in
+                // a group, so the term is not cached: an open bracket typed
+                // before it changes where the term ends.
+                t->span = 0;
+                fr->cur.error = 1;
+                if (fr->term >= 0)
+                    token_at(inc, fr->term)->cached = 0;
+                fr->term = -1;
+            }
+            i++;
+            break;
+        default:
+            fr->cur.error = 1;
+            i++;
+            break;
+        }
+    }
+    inc->folded = folded;
+    if (i < 0) {
+        memset(&inc->res, 0, sizeof(inc->res));
+        inc->error = 1;
+        return 0;
+    }
+
+    // Brackets still open at the end are errors
+    while (frames > 1)
+        pop_group(inc, &frames, inc->count - 1, 0);
+    ccal_incr_frame* root = &inc->frames[0];
+    end_term(inc, root, inc->count - 1);
+    ccal_incr_part f = root->sum;
+    if (f.error || f.depth > inc->max_depth) {
+        memset(&inc->res, 0, sizeof(inc->res));
+        inc->error = 1;
+    }
+    else {
+        ccal_settle(&f.value);
+        ccal_result res = { f.value.value, f.has_dec, f.max_dec, 0,
+                            f.value.mant, f.value.scale, f.value.exact };
+        inc->res = res;
+        inc->error = 0;
+    }
+    return 1;
+}
+
+// Result of the expression as it stands, as ccal_evaluate_result would
+// return it for the same text. Only the parts changed since the last call
+// are evaluated again. If the expression is invalid, *error is set to 1.
+ccal_result ccal_incr_result(ccal_incr* inc, int* error) {
+    // Tokens dropped when memory ran out are lexed again first
+    if (inc->count == 0 && inc->len > 0)
+        ccal_incr_edit(inc, 0, 0, "", 0);
+    if (inc->stale)
+        inc->stale = !evaluate(inc);
+    *error = inc->error;
+    return inc->res;
+}
@@ -0,0 +1,82 @@
+// modules/incremental.h
+// Header file for incremental evaluation
+// Declares an evaluator that keeps the tokens and partial results of one
+// expression while it is edited, so each edit re-lexes only the text it
+// touched and recomputes only the brackets and operators that depend on it
+
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include <stddef.h>
+
+#include "../ccal.h"
+
+// Value of part of an expression, a bracket group or a single term, with
+// the precision and nesting gathered while computing it.
+typedef struct {
+    ccal_num value;
+    int has_dec;      // a number in it had a decimal point
+    int max_dec;      // most meaningful decimals among its numbers
+    int depth;        // deepest brackets and unary minuses inside it
+    int error;        // it cannot be evaluated
+} ccal_incr_part;
+
+// Token of the edited expression with what evaluation remembered about it.
+// Tokens live in a gap buffer: those before the gap keep tok.start, tok.look
+// and reach as offsets from the start of the text, those after it as
+// offsets from the end, so an edit never has to renumber the tokens that
+// follow it.
+typedef struct {
+    ccal_token tok;
+    size_t reach;     // furthest tok.look of this and every earlier token
+    int operand;      // lexed in operand position
+    int owner;        // + or -: tokens back to the open bracket of its group (index + 1 at top level)
+    int span;         // open bracket: tokens to its close bracket, 0 while unclosed;
+                      // close bracket: tokens back to its open bracket, 0 if stray;
+                      // + or -: tokens to the last one of the term after it
+    int cached;       // open bracket, + or -: part is up to date
+    ccal_incr_part part;    // open bracket: the group; + or -: the term after it
+    ccal_incr_part before;  // + or -: the terms of its group before it, joined
+} ccal_incr_token;
+
+// Group being folded while evaluating.
+typedef struct {
+    int open;         // index of its open bracket, -1 for the whole expression
+    int term;         // index of the + or - before the current term, -1 for the first
+    int op;           // x, / or ^ waiting for its right operand
+    int negs;         // unary minuses waiting for the next operand
+    int any;          // the current term has an operand
+    int sum_op;       // + or - joining the current term to sum, 0 for the first
+    ccal_incr_part sum;  // terms before the current one, joined
+    ccal_incr_part cur;  // current term so far
+} ccal_incr_frame;
+
+// Expression under edit.
+typedef struct {
+    char* text;
+    size_t len;
+    size_t cap;
+    ccal_incr_token* tokens;   // count tokens around a gap of token_cap - count
+    int count;
+    int gap;                   // index of the first token after the gap
+    int token_cap;
+    ccal_incr_frame* frames;   // scratch stack of open groups while evaluating
+    int frame_cap;
+    int max_depth;             // nesting limit, CCAL_MAX_DEPTH by default
+    int stale;                 // edited since the last evaluation
+    int damage_lo;             // tokens [damage_lo, damage_hi) changed since then
+    int damage_hi;
+    ccal_result res;           // last result and its error flag
+    int error;
+    size_t lexed;              // tokens the last edit lexed
+    size_t folded;             // tokens the last evaluation visited
+} ccal_incr;
+
+// Function declarations
+CCAL_API void ccal_incr_init(ccal_incr* inc);
+CCAL_API void ccal_incr_free(ccal_incr* inc);
+CCAL_API int ccal_incr_set(ccal_incr* inc, const char* text, size_t len);
+CCAL_API int ccal_incr_edit(ccal_incr* inc, size_t pos, size_t del, const char* ins, size_t ins_len);
+CCAL_API ccal_result ccal_incr_result(ccal_incr* inc, int* error);
+
+#endif // INCREMENTAL_H
@@ -0,0 +1,116 @@
+// modules/latency.c
+// Latency histograms for ccal calculator
+// Merges the per-thread histograms recorded in batch and server modes and
+// prints their percentiles, converting clock ticks to nanoseconds against
+// the monotonic clock over the run
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "latency.h"
+
+// Shortest stretch of time the tick rate is measured over
+#define LATENCY_CALIBRATE_NS 10000000.0
+
+static const char* const stage_names[LATENCY_STAGES] = { "evaluate", "format", "convert" };
+
+// Clock readings taken when the first histogram was created
+static uint64_t start_ticks;
+static double start_ns;
+
+static double monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Nanoseconds per tick, measured from the first latency_create until now,
+// waiting briefly when that was too short to tell.
+static double ns_per_tick(void) {
+    double ns;
+    uint64_t ticks;
+    while ((ns = monotonic_ns() - start_ns) < LATENCY_CALIBRATE_NS)
+        ;
+    ticks = latency_now() - start_ticks;
+    return ticks ? ns / (double)ticks : 1.0;
+}
+
+// Allocate an empty set of histograms. Returns NULL if memory runs out.
+latency_set* latency_create(void) {
+    if (start_ns == 0) {
+        start_ns = monotonic_ns();
+        start_ticks = latency_now();
+    }
+    return calloc(1, sizeof(latency_set));
+}
+
+// Add the samples of one set into another. from may still be recording on
+// another thread; the sum is then a snapshot a few samples behind.
+void latency_merge(latency_set* into, const latency_set* from) {
+    for (int s = 0; s < LATENCY_STAGES; s++) {
+        latency_hist* a = &into->stage[s];
+        const latency_hist* b = &from->stage[s];
+        for (int i = 0; i < LATENCY_BUCKETS; i++) {
+            uint64_t n = atomic_load_explicit(&b->counts[i], memory_order_relaxed);
+            if (n)
+                atomic_fetch_add_explicit(&a->counts[i], n, memory_order_relaxed);
+        }
+        atomic_fetch_add_explicit(&a->total, atomic_load_explicit(&b->total, memory_order_relaxed),
+                                  memory_order_relaxed);
+        uint64_t max = atomic_load_explicit(&b->max, memory_order_relaxed);
+        if (max > atomic_load_explicit(&a->max, memory_order_relaxed))
+            atomic_store_explicit(&a->max, max, memory_order_relaxed);
+    }
+}
+
+// Largest number of ticks recorded into a bucket.
+static uint64_t bucket_high(int i) {
+    if (i < 2 * LATENCY_SUB)
+        return (uint64_t)i;
+    int shift = i / LATENCY_SUB - 1;
+    return ((uint64_t)(i - shift * LATENCY_SUB + 1) << shift) - 1;
+}
+
+// Ticks at or below which a fraction q of the samples fall.
+static uint64_t percentile(const latency_hist* h, uint64_t total, double q) {
+    uint64_t rank = (uint64_t)(q * (double)total + 0.999999);
+    uint64_t max = atomic_load_explicit(&h->max, memory_order_relaxed);
+    uint64_t seen = 0;
+    if (rank == 0)
+        rank = 1;
+    for (int i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += atomic_load_explicit(&h->counts[i], memory_order_relaxed);
+        if (seen >= rank) {
+            // The top bucket has no upper bound of its own
+            uint64_t high = i < LATENCY_BUCKETS - 1 ? bucket_high(i) : max;
+            return high < max ? high : max;
+        }
+    }
+    return max;
+}
+
+// Print the count and p50, p99, p99.9 and maximum in nanoseconds of every
+// stage that has samples.
+void latency_print(FILE* fp, const latency_set* set) {
+    double scale = ns_per_tick();
+
+    fprintf(fp, "%-12s %12s %10s %10s %10s %10s\n", "Latency (ns)", "count", "p50", "p99", "p999", "max");
+    for (int s = 0; s < LATENCY_STAGES; s++) {
+        const latency_hist* h = &set->stage[s];
+        uint64_t total = atomic_load_explicit(&h->total, memory_order_relaxed);
+        if (total == 0)
+            continue;
+        fprintf(fp, "%-12s %12llu %10.0f %10.0f %10.0f %10.0f\n", stage_names[s],
+                (unsigned long long)total,
+                (double)percentile(h, total, 0.50) * scale,
+                (double)percentile(h, total, 0.99) * scale,
+                (double)percentile(h, total, 0.999) * scale,
+                (double)atomic_load_explicit(&h->max, memory_order_relaxed) * scale);
+    }
+    fflush(fp);
+}
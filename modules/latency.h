@@ -0,0 +1,96 @@
+// modules/latency.h
+// Header file for latency histograms
+// Declares HDR-style histograms that batch and server modes fill with the
+// time each expression spends in evaluation and formatting, and each
+// conversion request in unit lookup, so tail latency can be read off at the
+// end of a run or whenever SIGUSR1 asks for it
+// Recording is inline: a clock read and one counter increment, no locks
+// and no allocation, since every thread records into its own histograms
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdatomic.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+
+// Bits of precision kept below each power of two: values are recorded
+// within 1/128 of their true size
+#define LATENCY_SUB_BITS 7
+#define LATENCY_SUB (1 << LATENCY_SUB_BITS)
+
+// Samples of 2^LATENCY_MAX_BITS ticks or more share the top bucket
+// (2^44 ticks is over an hour at a few GHz)
+#define LATENCY_MAX_BITS 44
+
+#define LATENCY_BUCKETS ((LATENCY_MAX_BITS - LATENCY_SUB_BITS + 1) * LATENCY_SUB)
+
+// What a histogram measures
+enum {
+    LATENCY_EVALUATE,   // parsing and evaluating one expression (one pass)
+    LATENCY_FORMAT,     // writing its result
+    LATENCY_CONVERT,    // rule and unit lookup and conversion of one request
+    LATENCY_STAGES
+};
+
+// Counts of samples by size in clock ticks. Only its owning thread records
+// into it; counters are atomics so another thread may read a snapshot
+// while it does.
+typedef struct {
+    _Atomic uint64_t counts[LATENCY_BUCKETS];
+    _Atomic uint64_t total;
+    _Atomic uint64_t max;
+} latency_hist;
+
+// One histogram per stage, owned by one thread
+typedef struct {
+    latency_hist stage[LATENCY_STAGES];
+} latency_set;
+
+// Read the clock in ticks: the time-stamp counter on x86, nanoseconds
+// elsewhere. latency_print converts ticks to nanoseconds.
+static inline uint64_t latency_now(void) {
+    #if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+    #else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+    #endif
+}
+
+// Bucket of a sample: exact below 2 * LATENCY_SUB, then LATENCY_SUB
+// buckets for each further power of two below 2^LATENCY_MAX_BITS.
+static inline int latency_bucket(uint64_t ticks) {
+    if (ticks < 2 * LATENCY_SUB)
+        return (int)ticks;
+    int msb = 63 - __builtin_clzll(ticks);
+    if (msb >= LATENCY_MAX_BITS)
+        return LATENCY_BUCKETS - 1;
+    int shift = msb - LATENCY_SUB_BITS;
+    return shift * LATENCY_SUB + (int)(ticks >> shift);
+}
+
+// Add one sample. Single writer, so a relaxed load and store suffice.
+static inline void latency_record(latency_hist* h, uint64_t ticks) {
+    _Atomic uint64_t* c = &h->counts[latency_bucket(ticks)];
+    atomic_store_explicit(c, atomic_load_explicit(c, memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+    atomic_store_explicit(&h->total, atomic_load_explicit(&h->total, memory_order_relaxed) + 1,
+                          memory_order_relaxed);
+    if (ticks > atomic_load_explicit(&h->max, memory_order_relaxed))
+        atomic_store_explicit(&h->max, ticks, memory_order_relaxed);
+}
+
+// Function declarations
+latency_set* latency_create(void);
+void latency_merge(latency_set* into, const latency_set* from);
+void latency_print(FILE* fp, const latency_set* set);
+
+#endif // LATENCY_H
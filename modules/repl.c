@@ -0,0 +1,331 @@
+// modules/repl.c
+// Interactive mode for ccal calculator
+// Reads one expression per line from stdin and prints its result with the
+// time it took, keeping one evaluator context and every conversion rule set
+// loaded so far for the rest of the session
+// Like the GUI after "=", a line starting with an operator continues from
+// the previous result, and "ans" stands for that result anywhere in a line
+
+#ifndef _WIN32
+#define _POSIX_C_SOURCE 200809L
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../ccal.h"
+#include "batch.h"
+#include "repl.h"
+
+// Initial size of the line and expression buffers
+#define REPL_LINE_LEN 256
+
+// Rule sets kept loaded during a session
+#define REPL_MAX_RULES 16
+
+// Longest rule name, as for the converter's unit names
+#define REPL_RULE_LEN 64
+
+// Shown before each line when reading from a terminal
+#define REPL_PROMPT "> "
+
+// Loaded rule set, looked up by name
+typedef struct {
+    char name[REPL_RULE_LEN];
+    ccal_rules* rules;
+} ReplRule;
+
+// Everything a session keeps between lines
+typedef struct {
+    ccal_ctx ctx;
+    ccal_result ans;                 // previous result, at full precision
+    int has_ans;                     // 1 when there is a previous result
+    ReplRule rules[REPL_MAX_RULES];
+    int rule_count;
+    char* expr;                      // line with the previous result filled in
+    size_t expr_cap;
+} ReplState;
+
+// Read one line into a growable buffer, without the trailing newline.
+// Returns the line length, or -1 at end of input or on a read error.
+static long read_line(FILE* fp, char** buf, size_t* cap) {
+    size_t len = 0;
+
+    while (fgets(*buf + len, (int)(*cap - len), fp)) {
+        len += strlen(*buf + len);
+        if (len > 0 && (*buf)[len - 1] == '\n') {
+            (*buf)[--len] = '\0';
+            break;
+        }
+        if (len + 1 < *cap)
+            break;  // last line without newline
+
+        // Line did not fit, grow the buffer and keep reading
+        char* grown = realloc(*buf, *cap * 2);
+        if (!grown)
+            return -1;
+        *buf = grown;
+        *cap *= 2;
+    }
+
+    if (len == 0 && (feof(fp) || ferror(fp)))
+        return -1;
+    return (long)len;
+}
+
+// Monotonic clock in seconds.
+static double repl_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+// Print the time a line took after its result.
+static void print_elapsed(double seconds) {
+    if (seconds < 1e-3)
+        printf("  (%.1f us)\n", seconds * 1e6);
+    else
+        printf("  (%.2f ms)\n", seconds * 1e3);
+}
+
+// Append len bytes to the expression buffer, growing it as needed.
+// Returns 0 if memory runs out.
+static int append_expr(ReplState* st, size_t* used, const char* text, size_t len) {
+    if (*used + len + 1 > st->expr_cap) {
+        size_t cap = st->expr_cap * 2;
+        while (cap < *used + len + 1)
+            cap *= 2;
+        char* grown = realloc(st->expr, cap);
+        if (!grown)
+            return 0;
+        st->expr = grown;
+        st->expr_cap = cap;
+    }
+    memcpy(st->expr + *used, text, len);
+    *used += len;
+    st->expr[*used] = '\0';
+    return 1;
+}
+
+// Operators that continue from the previous result, as the GUI's buttons do.
+static int is_chain_operator(char c) {
+    return c == '+' || c == '-' || c == 'x' || c == 'X' || c == '*' || c == '/' || c == '^';
+}
+
+// Build the expression to evaluate from a line, continuing from the
+// previous result when the line starts with an operator. The evaluator
+// reads each word "ans" as that result itself, not as the digits printed
+// for it. Returns the expression length, or -1 if memory runs out.
+static long expand_line(ReplState* st, const char* line, size_t len) {
+    size_t used = 0;
+    size_t start = 0;
+    st->expr[0] = '\0';
+
+    while (start < len && isspace((unsigned char)line[start]))
+        start++;
+    if (start < len && is_chain_operator(line[start]) && st->has_ans) {
+        if (!append_expr(st, &used, "ans ", 4))
+            return -1;
+    }
+    if (!append_expr(st, &used, line, len))
+        return -1;
+    return (long)used;
+}
+
+// Find a loaded rule set, loading it when it is not in memory yet and
+// dropping the oldest when the table is full. Returns NULL if it cannot be
+// loaded.
+static ccal_rules* repl_load_rules(ReplState* st, const char* name) {
+    for (int i = 0; i < st->rule_count; i++) {
+        if (strcasecmp(st->rules[i].name, name) == 0)
+            return st->rules[i].rules;
+    }
+    if (strlen(name) >= REPL_RULE_LEN)
+        return NULL;
+    ccal_rules* rules = ccal_rules_load(name);
+    if (!rules)
+        return NULL;
+
+    if (st->rule_count == REPL_MAX_RULES) {
+        ccal_rules_free(st->rules[0].rules);
+        memmove(&st->rules[0], &st->rules[1], sizeof(ReplRule) * (REPL_MAX_RULES - 1));
+        st->rule_count--;
+    }
+    strcpy(st->rules[st->rule_count].name, name);
+    st->rules[st->rule_count].rules = rules;
+    st->rule_count++;
+    return rules;
+}
+
+// Check for a line starting with the command line's module flag.
+static int is_module_line(const char* line, size_t len) {
+    static const char* const flags[] = { "/M", "-m", "--module" };
+    for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); i++) {
+        size_t n = strlen(flags[i]);
+        if (len > n && memcmp(line, flags[i], n) == 0 && (line[n] == ' ' || line[n] == '\t'))
+            return 1;
+    }
+    return 0;
+}
+
+// Answer "-m converter [rule] <value> <from_unit> <to_unit>" with the line
+// the command line prints for it. Without a rule name, the rule sets
+// already loaded are tried before embedded rules are searched, so a rule
+// named once may be left out afterwards.
+static void repl_module(ReplState* st, char* line) {
+    char* argv[7];
+    int argc = 0;
+
+    for (char* tok = strtok(line, " \t"); tok; tok = strtok(NULL, " \t")) {
+        if (argc == 7) {
+            argc++;
+            break;
+        }
+        argv[argc++] = tok;
+    }
+    if (argc != 5 && argc != 6) {
+        printf("Error: Usage: -m <module> [rule] <value> <from_unit> <to_unit>");
+        return;
+    }
+    if (strcmp(argv[1], "converter") != 0) {
+        printf("Error: Unknown module '%s'", argv[1]);
+        return;
+    }
+
+    double value = atof(argv[argc - 3]);
+    const char* from_unit = argv[argc - 2];
+    const char* to_unit = argv[argc - 1];
+    double result = 0;
+    ccal_rules* rules = NULL;
+    int status = CCAL_CONVERT_OK;
+
+    if (argc == 6) {
+        rules = repl_load_rules(st, argv[2]);
+        if (!rules) {
+            printf("Error: Failed to load conversion rules for '%s'", argv[2]);
+            return;
+        }
+        status = ccal_convert(rules, value, from_unit, to_unit, &result);
+    }
+    else {
+        for (int i = st->rule_count - 1; i >= 0 && !rules; i--) {
+            if (ccal_convert(st->rules[i].rules, value, from_unit, to_unit, &result) == CCAL_CONVERT_OK)
+                rules = st->rules[i].rules;
+        }
+        const char* rule_name = rules ? NULL : ccal_rules_detect(from_unit, to_unit);
+        if (rule_name)
+            rules = repl_load_rules(st, rule_name);
+        if (!rules) {
+            printf("Error: Could not auto-detect rule for units '%s' and '%s'",
+                   from_unit, to_unit);
+            return;
+        }
+        status = ccal_convert(rules, value, from_unit, to_unit, &result);
+    }
+
+    if (status == CCAL_CONVERT_UNKNOWN_FROM) {
+        printf("Error: Unknown unit '%s'", from_unit);
+        return;
+    }
+    if (status == CCAL_CONVERT_UNKNOWN_TO) {
+        printf("Error: Unknown target unit '%s'", to_unit);
+        return;
+    }
+    if (status != CCAL_CONVERT_OK) {
+        printf("Error: Conversion not defined");
+        return;
+    }
+    char from_short[REPL_RULE_LEN];
+    ccal_unit_short_name(rules, from_unit, from_short, sizeof(from_short));
+    printf("%.6f %s = %.6f %s", value, from_short, result, to_unit);
+}
+
+// Evaluate one arithmetic line and print its result, remembering it for
+// the next line. After an error the next line starts fresh, as in the GUI.
+static void repl_evaluate(ReplState* st, const char* line, size_t len) {
+    int error = 1;
+    long expr_len = expand_line(st, line, len);
+    ccal_result res;
+
+    char out[CCAL_RESULT_MAX];
+
+    st->ctx.ans = st->has_ans ? &st->ans : NULL;
+    if (expr_len >= 0)
+        res = ccal_evaluate_result(&st->ctx, st->expr, (size_t)expr_len, &error);
+    if (error) {
+        st->has_ans = 0;
+        printf(BATCH_ERROR_MARKER);
+        return;
+    }
+    st->ans = res;
+    st->has_ans = 1;
+    out[ccal_write_result(&res, 0, out)] = '\0';
+    printf("%s", out);
+}
+
+// Evaluate lines from stdin until end of input or "exit". Returns 0, or 1
+// if memory runs out.
+int run_repl(void) {
+    ReplState st;
+    size_t cap = REPL_LINE_LEN;
+    char* line = malloc(cap);
+    int interactive = isatty(fileno(stdin));
+    long len;
+
+    memset(&st, 0, sizeof(st));
+    ccal_ctx_init(&st.ctx);
+    st.expr_cap = REPL_LINE_LEN;
+    st.expr = malloc(st.expr_cap);
+    if (!line || !st.expr) {
+        free(line);
+        free(st.expr);
+        return 1;
+    }
+
+    for (;;) {
+        if (interactive) {
+            printf(REPL_PROMPT);
+            fflush(stdout);
+        }
+        if ((len = read_line(stdin, &line, &cap)) < 0)
+            break;
+        if (len > 0 && line[len - 1] == '\r')
+            line[--len] = '\0';
+
+        // Session commands, then blank lines, which leave the result alone
+        size_t start = 0;
+        while (start < (size_t)len && isspace((unsigned char)line[start]))
+            start++;
+        if (strcmp(line + start, "exit") == 0 || strcmp(line + start, "quit") == 0)
+            break;
+        if (strcmp(line + start, "clear") == 0) {
+            st.has_ans = 0;
+            continue;
+        }
+        if (start == (size_t)len)
+            continue;
+
+        double t0 = repl_now();
+        if (is_module_line(line + start, len - start))
+            repl_module(&st, line + start);
+        else
+            repl_evaluate(&st, line, (size_t)len);
+        print_elapsed(repl_now() - t0);
+        if (interactive)
+            fflush(stdout);
+    }
+
+    if (interactive)
+        printf("\n");
+    for (int i = 0; i < st.rule_count; i++)
+        ccal_rules_free(st.rules[i].rules);
+    ccal_ctx_free(&st.ctx);
+    free(st.expr);
+    free(line);
+    return 0;
+}
@@ -0,0 +1,12 @@
+// modules/repl.h
+// Header file for interactive mode
+// Declares the read-eval-print loop that keeps one process, one evaluator
+// context and the conversion rules it loaded alive for a whole session
+
+#ifndef REPL_H
+#define REPL_H
+
+// Function declarations
+int run_repl(void);
+
+#endif // REPL_H
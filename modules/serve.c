@@ -0,0 +1,578 @@
+// modules/serve.c
+// Server mode for ccal calculator
+// Listens on a Unix domain socket and answers every request line with one
+// response line over persistent connections, so a client pays for one
+// connection instead of one process start per calculation
+// A single epoll loop serves all clients; conversion rules are loaded on
+// first use and stay in memory for the life of the server
+// With --latency the time each request spends in evaluation, formatting or
+// unit conversion is recorded into histograms printed on SIGUSR1 and at exit
+
+#ifdef __linux__
+#define _GNU_SOURCE  // accept4
+#endif
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#ifdef __linux__
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#endif
+
+#include "../ccal.h"
+#include "batch.h"
+#include "converter.h"
+#include "latency.h"
+#include "serve.h"
+
+// Bytes read from a client per call
+#define SERVE_READ_LEN (1 << 16)
+
+// Longest request line; a longer one is answered with an error and the
+// connection is closed
+#define SERVE_MAX_LINE (1 << 20)
+
+// Unsent response bytes after which a client's input waits until it reads
+#define SERVE_MAX_PENDING (1 << 22)
+
+// Longest module request line
+#define SERVE_MODULE_LEN 256
+
+// Rule sets kept loaded at once
+#define SERVE_MAX_RULES 16
+
+// Events taken per epoll_wait
+#define SERVE_EVENTS 64
+
+#ifdef __linux__
+
+// A conversion rule set, loaded on first use
+typedef struct {
+    char name[32];
+    ccal_rules* rules;
+} ServeRule;
+
+// One client connection
+typedef struct ServeConn {
+    int fd;
+    unsigned int events;     // epoll events currently watched
+    char* in;                // received bytes not yet answered
+    size_t in_len;
+    size_t in_cap;
+    char* out;               // responses not yet sent
+    size_t out_pos;          // first unsent byte
+    size_t out_len;
+    size_t out_cap;
+    int eof;                 // no more requests; close once responses are sent
+    int dead;                // close now
+    struct ServeConn* prev;  // list of open connections
+    struct ServeConn* next;
+} ServeConn;
+
+// State shared by every connection
+typedef struct {
+    ccal_ctx ctx;            // evaluator state, reused for every request
+    ServeRule* rules;        // loaded rule sets
+    int rule_count;
+    ServeConn* conns;        // open connections
+    latency_set* latency;    // histograms, NULL without --latency
+} ServeState;
+
+// Set by SIGINT and SIGTERM
+static volatile sig_atomic_t serve_stop = 0;
+
+// Set by SIGUSR1 to ask for the latency histograms so far
+static volatile sig_atomic_t serve_dump = 0;
+
+static void serve_signal(int sig) {
+    if (sig == SIGUSR1)
+        serve_dump = 1;
+    else
+        serve_stop = 1;
+}
+
+// Make room for len more response bytes. Returns 0 when memory is short.
+static int conn_reserve(ServeConn* c, size_t len) {
+    if (c->out_len + len <= c->out_cap)
+        return 1;
+
+    // Reuse the space of bytes already sent before growing
+    if (c->out_pos > 0) {
+        memmove(c->out, c->out + c->out_pos, c->out_len - c->out_pos);
+        c->out_len -= c->out_pos;
+        c->out_pos = 0;
+        if (c->out_len + len <= c->out_cap)
+            return 1;
+    }
+
+    size_t cap = c->out_cap ? c->out_cap : SERVE_READ_LEN;
+    while (cap < c->out_len + len)
+        cap *= 2;
+    char* grown = realloc(c->out, cap);
+    if (!grown)
+        return 0;
+    c->out = grown;
+    c->out_cap = cap;
+    return 1;
+}
+
+// Queue one formatted response line.
+static void conn_printf(ServeConn* c, const char* fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    int len = vsnprintf(NULL, 0, fmt, ap);
+    va_end(ap);
+    if (len < 0 || !conn_reserve(c, (size_t)len + 1)) {
+        c->dead = 1;
+        return;
+    }
+    va_start(ap, fmt);
+    vsnprintf(c->out + c->out_len, (size_t)len + 1, fmt, ap);
+    va_end(ap);
+    c->out_len += len;
+}
+
+// Find a loaded rule set, loading it the way the command line does when
+// it is not in memory yet and dropping the oldest when the table is full.
+// Returns NULL if it cannot be loaded.
+static ccal_rules* serve_load_rules(ServeState* st, const char* name) {
+    for (int i = 0; i < st->rule_count; i++) {
+        if (strcasecmp(st->rules[i].name, name) == 0)
+            return st->rules[i].rules;
+    }
+    if (strlen(name) >= sizeof(st->rules[0].name))
+        return NULL;
+    ccal_rules* rules = ccal_rules_load(name);
+    if (!rules)
+        return NULL;
+
+    if (st->rule_count == SERVE_MAX_RULES) {
+        ccal_rules_free(st->rules[0].rules);
+        memmove(&st->rules[0], &st->rules[1], sizeof(ServeRule) * (SERVE_MAX_RULES - 1));
+        st->rule_count--;
+    }
+    ServeRule* rule = &st->rules[st->rule_count++];
+    strcpy(rule->name, name);
+    rule->rules = rules;
+    return rules;
+}
+
+// Answer "-m converter [rule] <value> <from_unit> <to_unit>" with the line
+// the command line prints for it.
+static void serve_module(ServeState* st, ServeConn* c, const char* line, size_t len) {
+    char buf[SERVE_MODULE_LEN];
+    char* argv[7];
+    int argc = 0;
+
+    if (len >= sizeof(buf)) {
+        conn_printf(c, "Error: Module request too long\n");
+        return;
+    }
+    memcpy(buf, line, len);
+    buf[len] = '\0';
+    for (char* tok = strtok(buf, " \t"); tok; tok = strtok(NULL, " \t")) {
+        if (argc == 7) {
+            argc++;
+            break;
+        }
+        argv[argc++] = tok;
+    }
+
+    if (argc != 5 && argc != 6) {
+        conn_printf(c, "Error: Usage: -m <module> [rule] <value> <from_unit> <to_unit>\n");
+        return;
+    }
+    if (strcmp(argv[1], "converter") != 0) {
+        conn_printf(c, "Error: Unknown module '%s'\n", argv[1]);
+        return;
+    }
+
+    const char* rule_name = argc == 6 ? argv[2] : NULL;
+    double value = atof(argv[argc - 3]);
+    const char* from_unit = argv[argc - 2];
+    const char* to_unit = argv[argc - 1];
+    uint64_t t0 = st->latency ? latency_now() : 0;
+
+    #ifdef USE_EMBEDDED_RULES
+    if (rule_name == NULL) {
+        // Prefer a rule set already in memory before parsing embedded rules
+        double probe;
+        for (int i = 0; !rule_name && i < st->rule_count; i++) {
+            if (ccal_convert(st->rules[i].rules, value, from_unit, to_unit, &probe) == CCAL_CONVERT_OK)
+                rule_name = st->rules[i].name;
+        }
+        if (rule_name == NULL)
+            rule_name = ccal_rules_detect(from_unit, to_unit);
+        if (rule_name == NULL) {
+            conn_printf(c, "Error: Could not auto-detect rule for units '%s' and '%s'\n",
+                        from_unit, to_unit);
+            return;
+        }
+    }
+    #else
+    if (rule_name == NULL) {
+        conn_printf(c, "Error: Rule name is required when using external rule files\n");
+        return;
+    }
+    #endif
+
+    ccal_rules* rules = serve_load_rules(st, rule_name);
+    if (!rules) {
+        conn_printf(c, "Error: Failed to load conversion rules for '%s'\n", rule_name);
+        return;
+    }
+    double result;
+    int status = ccal_convert(rules, value, from_unit, to_unit, &result);
+    if (status == CCAL_CONVERT_UNKNOWN_FROM) {
+        conn_printf(c, "Error: Unknown unit '%s'\n", from_unit);
+        return;
+    }
+    if (status == CCAL_CONVERT_UNKNOWN_TO) {
+        conn_printf(c, "Error: Unknown target unit '%s'\n", to_unit);
+        return;
+    }
+    if (status != CCAL_CONVERT_OK) {
+        conn_printf(c, "Error: Conversion not defined\n");
+        return;
+    }
+
+    char from_short[MAX_NAME_LEN];
+    ccal_unit_short_name(rules, from_unit, from_short, sizeof(from_short));
+    if (st->latency)
+        latency_record(&st->latency->stage[LATENCY_CONVERT], latency_now() - t0);
+    conn_printf(c, "%.6f %s = %.6f %s\n", value, from_short, result, to_unit);
+}
+
+// Check for a request starting with the command line's module flag.
+static int is_module_request(const char* line, size_t len) {
+    static const char* const flags[] = { "/M", "-m", "--module" };
+    for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); i++) {
+        size_t n = strlen(flags[i]);
+        if (len > n && memcmp(line, flags[i], n) == 0 && (line[n] == ' ' || line[n] == '\t'))
+            return 1;
+    }
+    return 0;
+}
+
+// Answer one request line: a module request, or an expression evaluated
+// like a line of batch mode.
+static void serve_line(ServeState* st, ServeConn* c, const char* line, size_t len) {
+    // Accept CRLF framing
+    if (len > 0 && line[len - 1] == '\r')
+        len--;
+
+    if (is_module_request(line, len)) {
+        serve_module(st, c, line, len);
+        return;
+    }
+
+    int error;
+    uint64_t t0 = st->latency ? latency_now() : 0;
+    ccal_result res = ccal_evaluate_result(&st->ctx, line, len, &error);
+    if (st->latency) {
+        uint64_t t1 = latency_now();
+        latency_record(&st->latency->stage[LATENCY_EVALUATE], t1 - t0);
+        t0 = t1;
+    }
+    if (!conn_reserve(c, CCAL_RESULT_MAX + sizeof(BATCH_ERROR_MARKER))) {
+        c->dead = 1;
+        return;
+    }
+    if (error) {
+        memcpy(c->out + c->out_len, BATCH_ERROR_MARKER "\n", sizeof(BATCH_ERROR_MARKER));
+        c->out_len += sizeof(BATCH_ERROR_MARKER);
+        return;
+    }
+    c->out_len += ccal_write_result(&res, 0, c->out + c->out_len);
+    c->out[c->out_len++] = '\n';
+    if (st->latency)
+        latency_record(&st->latency->stage[LATENCY_FORMAT], latency_now() - t0);
+}
+
+// Read what a client sent and answer every complete line in it.
+static void conn_read(ServeState* st, ServeConn* c) {
+    if (c->in_cap - c->in_len < SERVE_READ_LEN) {
+        size_t cap = c->in_cap ? c->in_cap * 2 : SERVE_READ_LEN;
+        while (cap - c->in_len < SERVE_READ_LEN)
+            cap *= 2;
+        char* grown = realloc(c->in, cap);
+        if (!grown) {
+            c->dead = 1;
+            return;
+        }
+        c->in = grown;
+        c->in_cap = cap;
+    }
+
+    ssize_t n = read(c->fd, c->in + c->in_len, c->in_cap - c->in_len);
+    if (n < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+            c->dead = 1;
+        return;
+    }
+    if (n == 0)
+        c->eof = 1;
+    c->in_len += (size_t)n;
+
+    const char* p = c->in;
+    const char* end = c->in + c->in_len;
+    const char* nl;
+    while (!c->dead && (nl = memchr(p, '\n', end - p))) {
+        serve_line(st, c, p, nl - p);
+        p = nl + 1;
+    }
+    c->in_len = end - p;
+    memmove(c->in, p, c->in_len);
+
+    // A last line without newline is answered when the client closes its
+    // side; a line that never ends is refused
+    if (c->in_len > 0 && c->eof)
+        serve_line(st, c, c->in, c->in_len);
+    else if (c->in_len > SERVE_MAX_LINE)
+        conn_printf(c, BATCH_ERROR_MARKER "\n");
+    else
+        return;
+    c->in_len = 0;
+    c->eof = 1;
+}
+
+// Send as much of the pending responses as the socket takes.
+static void conn_write(ServeConn* c) {
+    while (c->out_pos < c->out_len) {
+        ssize_t n = send(c->fd, c->out + c->out_pos, c->out_len - c->out_pos, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK)
+                c->dead = 1;
+            return;
+        }
+        c->out_pos += (size_t)n;
+    }
+    c->out_pos = 0;
+    c->out_len = 0;
+}
+
+// Watch a connection for what lets it make progress: input while its
+// responses keep up, output while responses are pending. Returns 0 when
+// there is nothing left to wait for.
+static int conn_watch(int ep, ServeConn* c) {
+    size_t pending = c->out_len - c->out_pos;
+    unsigned int events = 0;
+    if (!c->eof && pending < SERVE_MAX_PENDING)
+        events |= EPOLLIN;
+    if (pending > 0)
+        events |= EPOLLOUT;
+    if (events == 0)
+        return 0;
+    if (events == c->events)
+        return 1;
+
+    struct epoll_event ev;
+    ev.events = events;
+    ev.data.ptr = c;
+    c->events = events;
+    return epoll_ctl(ep, EPOLL_CTL_MOD, c->fd, &ev) == 0;
+}
+
+// Close a connection and release its buffers.
+static void conn_close(ServeState* st, ServeConn* c) {
+    if (c->prev)
+        c->prev->next = c->next;
+    else
+        st->conns = c->next;
+    if (c->next)
+        c->next->prev = c->prev;
+    close(c->fd);
+    free(c->in);
+    free(c->out);
+    free(c);
+}
+
+// Accept every pending connection.
+static void serve_accept(ServeState* st, int ep, int lfd) {
+    for (;;) {
+        int fd = accept4(lfd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+            return;
+
+        ServeConn* c = calloc(1, sizeof(ServeConn));
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.ptr = c;
+        if (!c || epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            close(fd);
+            free(c);
+            continue;
+        }
+        c->fd = fd;
+        c->events = EPOLLIN;
+        c->next = st->conns;
+        if (st->conns)
+            st->conns->prev = c;
+        st->conns = c;
+    }
+}
+
+// Create the listening socket. A socket file left by a server that did not
+// exit cleanly is replaced; one a server still answers on is not.
+// Returns the socket, or -1 after printing an error.
+static int serve_listen(const char* path) {
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Error: Socket path too long: %s\n", path);
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+
+    struct stat st;
+    if (lstat(path, &st) == 0 && S_ISSOCK(st.st_mode)) {
+        int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        int live = probe >= 0 && connect(probe, (struct sockaddr*)&addr, sizeof(addr)) == 0;
+        if (probe >= 0)
+            close(probe);
+        if (live) {
+            fprintf(stderr, "Error: A server is already listening on %s\n", path);
+            return -1;
+        }
+        unlink(path);
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0 || bind(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0 ||
+        listen(fd, SOMAXCONN) != 0) {
+        fprintf(stderr, "Error: Cannot listen on %s\n", path);
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Serve requests on a Unix domain socket until SIGINT or SIGTERM.
+// Returns 0 after a clean shutdown, 1 if the server could not run.
+int run_serve(const ServeOptions* opts) {
+    ServeState st;
+    memset(&st, 0, sizeof(st));
+    ccal_ctx_init(&st.ctx);
+    st.rules = calloc(SERVE_MAX_RULES, sizeof(ServeRule));
+    if (opts->latency)
+        st.latency = latency_create();
+    if (!st.rules || (opts->latency && !st.latency)) {
+        fprintf(stderr, "Memory error\n");
+        free(st.rules);
+        free(st.latency);
+        return 1;
+    }
+
+    int lfd = serve_listen(opts->path);
+    int ep = lfd >= 0 ? epoll_create1(EPOLL_CLOEXEC) : -1;
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;  // the listener is the only entry without a connection
+    if (lfd >= 0 && (ep < 0 || epoll_ctl(ep, EPOLL_CTL_ADD, lfd, &ev) != 0)) {
+        fprintf(stderr, "Error: Cannot start server\n");
+        close(lfd);
+        unlink(opts->path);
+        lfd = -1;
+    }
+    if (lfd < 0) {
+        if (ep >= 0)
+            close(ep);
+        free(st.rules);
+        free(st.latency);
+        return 1;
+    }
+
+    // The stop signals, and SIGUSR1 with --latency, stay blocked except
+    // while waiting, so one arriving between the check and the wait cannot
+    // be missed
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = serve_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    sigset_t stop_set, wait_set;
+    sigemptyset(&stop_set);
+    sigaddset(&stop_set, SIGINT);
+    sigaddset(&stop_set, SIGTERM);
+    if (st.latency) {
+        sigaction(SIGUSR1, &sa, NULL);
+        sigaddset(&stop_set, SIGUSR1);
+    }
+    sigprocmask(SIG_BLOCK, &stop_set, &wait_set);
+    sigdelset(&wait_set, SIGINT);
+    sigdelset(&wait_set, SIGTERM);
+    sigdelset(&wait_set, SIGUSR1);
+
+    struct epoll_event events[SERVE_EVENTS];
+    int failed = 0;
+    while (!serve_stop) {
+        int n = epoll_pwait(ep, events, SERVE_EVENTS, -1, &wait_set);
+        if (serve_dump) {
+            serve_dump = 0;
+            latency_print(stderr, st.latency);
+        }
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            fprintf(stderr, "Error: Server wait failed\n");
+            failed = 1;
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            ServeConn* c = events[i].data.ptr;
+            if (!c) {
+                serve_accept(&st, ep, lfd);
+                continue;
+            }
+            if (events[i].events & EPOLLERR)
+                c->dead = 1;
+            if (!c->dead && !c->eof && (events[i].events & (EPOLLIN | EPOLLHUP)))
+                conn_read(&st, c);
+            if (!c->dead)
+                conn_write(c);
+            if (c->dead || !conn_watch(ep, c))
+                conn_close(&st, c);
+        }
+    }
+
+    while (st.conns)
+        conn_close(&st, st.conns);
+    close(ep);
+    close(lfd);
+    unlink(opts->path);
+    if (st.latency) {
+        latency_print(stderr, st.latency);
+        free(st.latency);
+    }
+    ccal_ctx_free(&st.ctx);
+    for (int i = 0; i < st.rule_count; i++)
+        ccal_rules_free(st.rules[i].rules);
+    free(st.rules);
+    return failed;
+}
+
+#else
+
+// Server mode relies on epoll and is only built on Linux.
+int run_serve(const ServeOptions* opts) {
+    (void)opts;
+    fprintf(stderr, "Error: --serve is only available on Linux\n");
+    return 1;
+}
+
+#endif
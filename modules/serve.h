@@ -0,0 +1,18 @@
+// modules/serve.h
+// Header file for server mode
+// Declares the function that answers newline-framed requests from clients
+// connected to a Unix domain socket, from one long-running process
+
+#ifndef SERVE_H
+#define SERVE_H
+
+// Options for a server run
+typedef struct {
+    const char* path;  // Unix domain socket to listen on
+    int latency;       // print latency histograms to stderr at exit and on SIGUSR1
+} ServeOptions;
+
+// Function declarations
+int run_serve(const ServeOptions* opts);
+
+#endif // SERVE_H
@@ -0,0 +1,220 @@
+// modules/shm.c
+// Shared-memory server for ccal calculator
+// Creates a named segment holding a request ring and a response ring and
+// evaluates requests as they appear, busy-polling while there is work so
+// the steady state needs no system call on either side
+// One client at a time is attached; responses come back in request order
+
+#ifndef _WIN32
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "../ccal.h"
+#include "batch.h"
+#include "shm.h"
+
+// Empty polls spent spinning, then yielding, before the server starts
+// sleeping between polls
+#define SHM_SPIN_POLLS (1 << 12)
+#define SHM_YIELD_POLLS (1 << 14)
+
+// Sleep between polls once idle, in nanoseconds
+#define SHM_IDLE_SLEEP_NS 50000
+
+#ifndef _WIN32
+
+// Set by SIGINT and SIGTERM
+static volatile sig_atomic_t shm_stop = 0;
+
+static void shm_signal(int sig) {
+    (void)sig;
+    shm_stop = 1;
+}
+
+// Hint to the processor that this is a spin-wait loop.
+static void shm_relax(void) {
+    #if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+    #elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+    #endif
+}
+
+// Wait after an empty poll: spin at first, then yield in case the client
+// shares the core, then sleep so an idle server does not hold a core.
+static void shm_backoff(unsigned* idle) {
+    ++*idle;
+    if (*idle < SHM_SPIN_POLLS) {
+        shm_relax();
+    }
+    else if (*idle < SHM_YIELD_POLLS) {
+        sched_yield();
+    }
+    else {
+        struct timespec ts = { 0, SHM_IDLE_SLEEP_NS };
+        nanosleep(&ts, NULL);
+        *idle = SHM_YIELD_POLLS;
+    }
+}
+
+// Write the name shm_open expects, with one leading '/', to path.
+// Returns 0 if it does not fit.
+static int shm_path(const char* name, char* path, size_t cap) {
+    int n = snprintf(path, cap, "%s%s", name[0] == '/' ? "" : "/", name);
+    return n > 1 && (size_t)n < cap;
+}
+
+// Create the named segment. A segment left by a server that is no longer
+// running is replaced; a live server's is not. Returns the mapping, or
+// NULL after printing an error.
+static ccal_shm_segment* shm_create(const char* path) {
+    int fd = shm_open(path, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0 && errno == EEXIST) {
+        int old = shm_open(path, O_RDONLY, 0);
+        struct stat st;
+        int live = 0;
+        if (old >= 0 && fstat(old, &st) == 0 && (size_t)st.st_size >= sizeof(ccal_shm_segment)) {
+            const ccal_shm_segment* seg = mmap(NULL, sizeof(ccal_shm_segment), PROT_READ,
+                                               MAP_SHARED, old, 0);
+            if (seg != MAP_FAILED) {
+                live = seg->magic == CCAL_SHM_MAGIC && seg->pid > 0 &&
+                       (kill(seg->pid, 0) == 0 || errno == EPERM);
+                munmap((void*)seg, sizeof(ccal_shm_segment));
+            }
+        }
+        if (old >= 0)
+            close(old);
+        if (live) {
+            fprintf(stderr, "Error: A server is already using %s\n", path);
+            return NULL;
+        }
+        shm_unlink(path);
+        fd = shm_open(path, O_RDWR | O_CREAT | O_EXCL, 0600);
+    }
+    if (fd < 0 || ftruncate(fd, sizeof(ccal_shm_segment)) != 0) {
+        fprintf(stderr, "Error: Cannot create shared memory %s\n", path);
+        if (fd >= 0) {
+            close(fd);
+            shm_unlink(path);
+        }
+        return NULL;
+    }
+
+    ccal_shm_segment* seg = mmap(NULL, sizeof(ccal_shm_segment), PROT_READ | PROT_WRITE,
+                                 MAP_SHARED, fd, 0);
+    close(fd);
+    if (seg == MAP_FAILED) {
+        fprintf(stderr, "Error: Cannot map shared memory %s\n", path);
+        shm_unlink(path);
+        return NULL;
+    }
+    seg->magic = CCAL_SHM_MAGIC;
+    seg->version = CCAL_SHM_VERSION;
+    seg->pid = (int32_t)getpid();
+    return seg;
+}
+
+// Evaluate one request slot into a response slot, formatted like a line
+// of batch mode.
+static void shm_answer(ccal_ctx* ctx, const ccal_shm_slot* req, ccal_shm_slot* resp) {
+    int error;
+    size_t len = req->len < CCAL_SHM_TEXT ? req->len : CCAL_SHM_TEXT;
+    ccal_result res = ccal_evaluate_result(ctx, req->text, len, &error);
+    resp->error = error;
+    if (error) {
+        memcpy(resp->text, BATCH_ERROR_MARKER, sizeof(BATCH_ERROR_MARKER) - 1);
+        resp->len = sizeof(BATCH_ERROR_MARKER) - 1;
+    }
+    else {
+        resp->len = (uint32_t)ccal_write_result(&res, 0, resp->text);
+    }
+}
+
+// Serve requests from a shared-memory segment until SIGINT or SIGTERM.
+// Returns 0 after a clean shutdown, 1 if the segment could not be created.
+int run_shm(const ShmOptions* opts) {
+    char path[256];
+    if (!shm_path(opts->name, path, sizeof(path))) {
+        fprintf(stderr, "Error: Invalid shared memory name: %s\n", opts->name);
+        return 1;
+    }
+    ccal_shm_segment* seg = shm_create(path);
+    if (!seg)
+        return 1;
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = shm_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    ccal_ctx ctx;
+    ccal_ctx_init(&ctx);
+    ccal_shm_ring* req = &seg->requests;
+    ccal_shm_ring* resp = &seg->responses;
+    uint32_t head = 0;       // requests taken
+    uint32_t tail = 0;       // responses written
+    uint32_t resp_head = 0;  // responses the client had read when last checked
+    unsigned idle = 0;
+    atomic_store_explicit(&seg->ready, 1, memory_order_release);
+
+    while (!shm_stop) {
+        uint32_t avail = atomic_load_explicit(&req->tail, memory_order_acquire);
+        if (avail == head) {
+            shm_backoff(&idle);
+            continue;
+        }
+        idle = 0;
+
+        // Answer every waiting request, publishing each response at once
+        while (head != avail && !shm_stop) {
+            if (tail - resp_head == CCAL_SHM_SLOTS) {
+                resp_head = atomic_load_explicit(&resp->head, memory_order_acquire);
+                if (tail - resp_head == CCAL_SHM_SLOTS) {
+                    shm_backoff(&idle);  // client is not reading responses
+                    continue;
+                }
+                idle = 0;
+            }
+            shm_answer(&ctx, &req->slots[head % CCAL_SHM_SLOTS],
+                       &resp->slots[tail % CCAL_SHM_SLOTS]);
+            head++;
+            tail++;
+            atomic_store_explicit(&req->head, head, memory_order_release);
+            atomic_store_explicit(&resp->tail, tail, memory_order_release);
+        }
+    }
+
+    atomic_store_explicit(&seg->ready, 0, memory_order_release);
+    ccal_ctx_free(&ctx);
+    munmap(seg, sizeof(ccal_shm_segment));
+    shm_unlink(path);
+    return 0;
+}
+
+#else
+
+// Named shared memory relies on POSIX shm_open.
+int run_shm(const ShmOptions* opts) {
+    (void)opts;
+    fprintf(stderr, "Error: --shm is not available on Windows\n");
+    return 1;
+}
+
+#endif
@@ -0,0 +1,78 @@
+// modules/shm.h
+// Header file for the shared-memory transport
+// Declares the segment layout shared by ccal --shm and its clients, the
+// server entry point and the client library in shm_client.c
+// A segment holds two single-producer/single-consumer rings, one for
+// requests and one for responses, so neither side makes a system call
+// while requests keep arriving
+
+#ifndef SHM_H
+#define SHM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+
+// Identifies a ccal segment and its layout version
+#define CCAL_SHM_MAGIC 0x4c414343u
+#define CCAL_SHM_VERSION 2
+
+// Slots per ring, a power of two
+#define CCAL_SHM_SLOTS 1024
+
+// Longest request or response text in one slot
+#define CCAL_SHM_TEXT 248
+
+// One request or response
+typedef struct {
+    uint32_t len;               // bytes of text
+    int32_t error;              // responses: 1 if the expression was invalid
+    char text[CCAL_SHM_TEXT];   // expression, or formatted result, no terminator
+} ccal_shm_slot;
+
+// Ring written by one side and read by the other. Each index only ever
+// grows and is written by one side, on its own cache line.
+typedef struct {
+    _Alignas(64) _Atomic uint32_t tail;  // slots written, by the producer
+    _Alignas(64) _Atomic uint32_t head;  // slots read, by the consumer
+    _Alignas(64) ccal_shm_slot slots[CCAL_SHM_SLOTS];
+} ccal_shm_ring;
+
+// Shared segment, created by the server
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    int32_t pid;                 // server process
+    _Atomic uint32_t ready;      // 1 while the server answers requests
+    _Atomic uint32_t attached;   // 1 while a client is connected
+    _Atomic int32_t client;      // that client's process, 0 while it connects
+    ccal_shm_ring requests;      // client to server
+    ccal_shm_ring responses;     // server to client, in request order
+} ccal_shm_segment;
+
+// Options for a shared-memory server run
+typedef struct {
+    const char* name;  // segment name, with or without the leading '/'
+} ShmOptions;
+
+// Client side of a segment
+typedef struct {
+    ccal_shm_segment* seg;
+    uint32_t req_tail;     // requests submitted
+    uint32_t req_head;     // requests the server had taken when last checked
+    uint32_t resp_head;    // responses received
+    uint32_t resp_tail;    // responses the server had written when last checked
+} ccal_shm_client;
+
+// Server (shm.c)
+int run_shm(const ShmOptions* opts);
+
+// Client library (shm_client.c)
+int ccal_shm_connect(ccal_shm_client* cl, const char* name);
+void ccal_shm_disconnect(ccal_shm_client* cl);
+int ccal_shm_submit(ccal_shm_client* cl, const char* expr, size_t len);
+int ccal_shm_receive(ccal_shm_client* cl, char* out, size_t cap, int* error);
+int ccal_shm_evaluate(ccal_shm_client* cl, const char* expr, size_t len,
+                      char* out, size_t cap, int* error);
+
+#endif // SHM_H
@@ -0,0 +1,221 @@
+// modules/shm_client.c
+// Client library for the shared-memory transport of ccal --shm
+// Submits expressions to the request ring and reads formatted results from
+// the response ring of a segment created by the server; apart from
+// connecting and disconnecting no call enters the kernel
+// Builds on its own: it needs only this file and shm.h
+
+#ifndef _WIN32
+#define _GNU_SOURCE
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "shm.h"
+
+// Polls ccal_shm_evaluate spins for a response before yielding the core
+#define SHM_CLIENT_SPINS (1 << 12)
+
+#ifndef _WIN32
+
+// Write the name shm_open expects, with one leading '/', to path.
+// Returns 0 if it does not fit.
+static int shm_path(const char* name, char* path, size_t cap) {
+    int n = snprintf(path, cap, "%s%s", name[0] == '/' ? "" : "/", name);
+    return n > 1 && (size_t)n < cap;
+}
+
+// Let the server answer every submitted request, skipping the responses as
+// they arrive so a full response ring cannot stall it, then mark them all
+// read.
+static void shm_drain(ccal_shm_segment* seg, uint32_t submitted) {
+    uint32_t done;
+    while ((done = atomic_load_explicit(&seg->responses.tail, memory_order_acquire)) != submitted &&
+           atomic_load_explicit(&seg->ready, memory_order_acquire))
+        atomic_store_explicit(&seg->responses.head, done, memory_order_release);
+    atomic_store_explicit(&seg->responses.head, submitted, memory_order_release);
+}
+
+// Take the segment over from an attached client whose process has exited
+// without disconnecting. Returns 1 if this process now holds it.
+static int shm_take_over(ccal_shm_segment* seg) {
+    int32_t pid = atomic_load_explicit(&seg->client, memory_order_acquire);
+    if (pid <= 0 || kill(pid, 0) == 0 || errno != ESRCH)
+        return 0;
+    if (!atomic_compare_exchange_strong(&seg->client, &pid, (int32_t)getpid()))
+        return 0;
+    // Whatever the old client left queued is answered and thrown away
+    shm_drain(seg, atomic_load_explicit(&seg->requests.tail, memory_order_relaxed));
+    return 1;
+}
+
+// Attach to the segment of a running ccal --shm server. Returns 1 on
+// success, 0 if there is no such server or another client is attached.
+// A client that exited without disconnecting does not count.
+int ccal_shm_connect(ccal_shm_client* cl, const char* name) {
+    char path[256];
+    memset(cl, 0, sizeof(*cl));
+    if (!shm_path(name, path, sizeof(path)))
+        return 0;
+
+    int fd = shm_open(path, O_RDWR, 0);
+    if (fd < 0)
+        return 0;
+    struct stat st;
+    void* map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(ccal_shm_segment))
+        map = mmap(NULL, sizeof(ccal_shm_segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED)
+        return 0;
+
+    ccal_shm_segment* seg = map;
+    uint32_t free_slot = 0;
+    if (!atomic_load_explicit(&seg->ready, memory_order_acquire) ||
+        seg->magic != CCAL_SHM_MAGIC || seg->version != CCAL_SHM_VERSION) {
+        munmap(map, sizeof(ccal_shm_segment));
+        return 0;
+    }
+    if (atomic_compare_exchange_strong(&seg->attached, &free_slot, 1)) {
+        atomic_store_explicit(&seg->client, (int32_t)getpid(), memory_order_release);
+    }
+    else if (!shm_take_over(seg)) {
+        munmap(map, sizeof(ccal_shm_segment));
+        return 0;
+    }
+
+    // Pick up where an earlier client left the rings
+    cl->seg = seg;
+    cl->req_tail = atomic_load_explicit(&seg->requests.tail, memory_order_relaxed);
+    cl->req_head = atomic_load_explicit(&seg->requests.head, memory_order_acquire);
+    cl->resp_head = atomic_load_explicit(&seg->responses.head, memory_order_relaxed);
+    cl->resp_tail = atomic_load_explicit(&seg->responses.tail, memory_order_acquire);
+    return 1;
+}
+
+// Detach from the segment so another client may connect. Responses not yet
+// received are dropped.
+void ccal_shm_disconnect(ccal_shm_client* cl) {
+    if (!cl->seg)
+        return;
+
+    ccal_shm_segment* seg = cl->seg;
+    shm_drain(seg, cl->req_tail);
+    atomic_store_explicit(&seg->client, 0, memory_order_relaxed);
+    atomic_store_explicit(&seg->attached, 0, memory_order_release);
+    munmap(seg, sizeof(ccal_shm_segment));
+    cl->seg = NULL;
+}
+
+// Queue an expression span for evaluation. Returns 1 if it was queued, 0 if
+// the request ring is full and responses should be received first, or -1 if
+// the expression is longer than CCAL_SHM_TEXT.
+int ccal_shm_submit(ccal_shm_client* cl, const char* expr, size_t len) {
+    if (len > CCAL_SHM_TEXT)
+        return -1;
+
+    ccal_shm_ring* req = &cl->seg->requests;
+    if (cl->req_tail - cl->req_head == CCAL_SHM_SLOTS) {
+        cl->req_head = atomic_load_explicit(&req->head, memory_order_acquire);
+        if (cl->req_tail - cl->req_head == CCAL_SHM_SLOTS)
+            return 0;
+    }
+
+    ccal_shm_slot* slot = &req->slots[cl->req_tail % CCAL_SHM_SLOTS];
+    memcpy(slot->text, expr, len);
+    slot->len = (uint32_t)len;
+    slot->error = 0;
+    cl->req_tail++;
+    atomic_store_explicit(&req->tail, cl->req_tail, memory_order_release);
+    return 1;
+}
+
+// Take the oldest response, if the server has written it. The result text
+// is stored in out with a terminator, cut short if cap is too small, and
+// *error is set to 1 for an invalid expression. Returns 1 if a response was
+// taken, 0 if none is ready yet.
+int ccal_shm_receive(ccal_shm_client* cl, char* out, size_t cap, int* error) {
+    ccal_shm_ring* resp = &cl->seg->responses;
+    if (cl->resp_head == cl->resp_tail) {
+        cl->resp_tail = atomic_load_explicit(&resp->tail, memory_order_acquire);
+        if (cl->resp_head == cl->resp_tail)
+            return 0;
+    }
+
+    const ccal_shm_slot* slot = &resp->slots[cl->resp_head % CCAL_SHM_SLOTS];
+    size_t len = slot->len < cap ? slot->len : cap - 1;
+    memcpy(out, slot->text, len);
+    out[len] = '\0';
+    *error = slot->error;
+    cl->resp_head++;
+    atomic_store_explicit(&resp->head, cl->resp_head, memory_order_release);
+    return 1;
+}
+
+// Evaluate one expression and wait for its result, spinning first and
+// yielding the core only when the server is slow to answer. Every earlier
+// request must have been received first. Returns 1 when out holds the
+// result, 0 if the expression is too long or the server stopped.
+int ccal_shm_evaluate(ccal_shm_client* cl, const char* expr, size_t len,
+                      char* out, size_t cap, int* error) {
+    if (ccal_shm_submit(cl, expr, len) != 1)
+        return 0;
+    for (unsigned spins = 0; !ccal_shm_receive(cl, out, cap, error); spins++) {
+        if (!atomic_load_explicit(&cl->seg->ready, memory_order_acquire))
+            return 0;
+        if (spins >= SHM_CLIENT_SPINS)
+            sched_yield();
+    }
+    return 1;
+}
+
+#else
+
+int ccal_shm_connect(ccal_shm_client* cl, const char* name) {
+    (void)name;
+    memset(cl, 0, sizeof(*cl));
+    return 0;
+}
+
+void ccal_shm_disconnect(ccal_shm_client* cl) {
+    (void)cl;
+}
+
+int ccal_shm_submit(ccal_shm_client* cl, const char* expr, size_t len) {
+    (void)cl;
+    (void)expr;
+    (void)len;
+    return -1;
+}
+
+int ccal_shm_receive(ccal_shm_client* cl, char* out, size_t cap, int* error) {
+    (void)cl;
+    (void)out;
+    (void)cap;
+    (void)error;
+    return 0;
+}
+
+int ccal_shm_evaluate(ccal_shm_client* cl, const char* expr, size_t len,
+                      char* out, size_t cap, int* error) {
+    (void)cl;
+    (void)expr;
+    (void)len;
+    (void)out;
+    (void)cap;
+    (void)error;
+    return 0;
+}
+
+#endif
@@ -0,0 +1,322 @@
+// python/ccalmodule.c
+// CPython extension module for ccal calculator
+// Evaluates expressions and converts units in process through the libccal
+// API, so Python callers no longer spawn a process per expression
+// evaluate_many releases the GIL and spreads a list over native threads,
+// each with its own context, and returns results in input order
+// Build with: python3 python/setup.py build_ext --inplace
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../ccal.h"
+
+// Expressions evaluated per release of the GIL, bounding the result buffer
+#define PY_CCAL_BLOCK (1 << 16)
+
+// Expressions a thread claims at a time
+#define PY_CCAL_GRAIN 256
+
+// Upper bound on threads, as for batch mode
+#define PY_CCAL_MAX_THREADS 256
+
+// Rule sets convert keeps loaded
+#define PY_CCAL_MAX_RULES 16
+
+// Raised for invalid expressions and failed conversions
+static PyObject* CcalError;
+
+// One expression and, once evaluated, its formatted result
+typedef struct {
+    const char* expr;         // UTF-8 text owned by the Python string
+    Py_ssize_t len;
+    size_t out_len;           // bytes of out
+    int error;                // 1 if the expression is invalid
+    char out[CCAL_RESULT_MAX];
+} PyCcalItem;
+
+// Expressions shared by the threads of one evaluate_many block
+typedef struct {
+    PyCcalItem* items;
+    size_t count;
+    atomic_size_t next;       // first item no thread has claimed yet
+} PyCcalBlock;
+
+// Rule set loaded by convert, kept for later calls
+typedef struct {
+    char name[256];
+    ccal_rules* rules;
+} PyCcalRule;
+
+// Loaded rule sets; only touched while holding the GIL
+static PyCcalRule loaded_rules[PY_CCAL_MAX_RULES];
+static int loaded_count = 0;
+
+// Evaluate one expression and format it the way batch mode prints it.
+static void evaluate_item(ccal_ctx* ctx, PyCcalItem* item) {
+    ccal_result res = ccal_evaluate_result(ctx, item->expr, (size_t)item->len, &item->error);
+    item->out_len = item->error ? 0 : ccal_write_result(&res, 0, item->out);
+}
+
+// Claim and evaluate runs of items until the block is exhausted.
+static void* evaluate_worker(void* arg) {
+    PyCcalBlock* blk = arg;
+    ccal_ctx ctx;
+
+    ccal_ctx_init(&ctx);
+    for (;;) {
+        size_t lo = atomic_fetch_add(&blk->next, PY_CCAL_GRAIN);
+        if (lo >= blk->count)
+            break;
+        size_t hi = lo + PY_CCAL_GRAIN < blk->count ? lo + PY_CCAL_GRAIN : blk->count;
+        for (size_t i = lo; i < hi; i++)
+            evaluate_item(&ctx, &blk->items[i]);
+    }
+    ccal_ctx_free(&ctx);
+    return NULL;
+}
+
+// Evaluate count items on up to threads threads, the calling one included.
+// Called without the GIL.
+static void evaluate_block(PyCcalItem* items, size_t count, int threads) {
+    PyCcalBlock blk;
+    pthread_t tids[PY_CCAL_MAX_THREADS];
+    size_t grains = (count + PY_CCAL_GRAIN - 1) / PY_CCAL_GRAIN;
+    int started = 0;
+
+    blk.items = items;
+    blk.count = count;
+    atomic_init(&blk.next, 0);
+    if ((size_t)threads > grains)
+        threads = (int)grains;
+
+    // A thread that cannot be started just leaves more work for the rest
+    while (started < threads - 1 &&
+           pthread_create(&tids[started], NULL, evaluate_worker, &blk) == 0)
+        started++;
+    evaluate_worker(&blk);
+    for (int i = 0; i < started; i++)
+        pthread_join(tids[i], NULL);
+}
+
+// Number of online processors, used for threads=0.
+static int online_processors(void) {
+    #ifdef _SC_NPROCESSORS_ONLN
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+    #else
+    return 1;
+    #endif
+}
+
+// evaluate(expr) -> str
+static PyObject* py_evaluate(PyObject* self, PyObject* arg) {
+    (void)self;
+    PyCcalItem item;
+    ccal_ctx ctx;
+
+    item.expr = PyUnicode_AsUTF8AndSize(arg, &item.len);
+    if (!item.expr)
+        return NULL;
+    ccal_ctx_init(&ctx);
+    evaluate_item(&ctx, &item);
+    ccal_ctx_free(&ctx);
+    if (item.error) {
+        PyErr_SetString(CcalError, "Invalid expression");
+        return NULL;
+    }
+    return PyUnicode_FromStringAndSize(item.out, (Py_ssize_t)item.out_len);
+}
+
+// evaluate_many(exprs, threads=0) -> list
+static PyObject* py_evaluate_many(PyObject* self, PyObject* args, PyObject* kwds) {
+    (void)self;
+    static char* kwlist[] = { "exprs", "threads", NULL };
+    PyObject* seq;
+    int threads = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|i:evaluate_many", kwlist, &seq, &threads))
+        return NULL;
+    if (threads < 0 || threads > PY_CCAL_MAX_THREADS) {
+        PyErr_Format(PyExc_ValueError, "threads must be between 0 and %d", PY_CCAL_MAX_THREADS);
+        return NULL;
+    }
+    if (threads == 0)
+        threads = online_processors();
+
+    // The tuple keeps every string, and so its UTF-8 text, alive while
+    // the GIL is released, even if the caller's list changes meanwhile
+    PyObject* tuple = PySequence_Tuple(seq);
+    if (!tuple)
+        return NULL;
+    Py_ssize_t n = PyTuple_GET_SIZE(tuple);
+    PyObject* results = PyList_New(n);
+    size_t block = n < PY_CCAL_BLOCK ? (size_t)n : PY_CCAL_BLOCK;
+    PyCcalItem* items = PyMem_RawMalloc((block ? block : 1) * sizeof(PyCcalItem));
+    if (!results || !items) {
+        PyErr_NoMemory();
+        goto fail;
+    }
+
+    for (Py_ssize_t base = 0; base < n; base += (Py_ssize_t)block) {
+        size_t count = (size_t)(n - base) < block ? (size_t)(n - base) : block;
+        for (size_t i = 0; i < count; i++) {
+            PyObject* expr = PyTuple_GET_ITEM(tuple, base + (Py_ssize_t)i);
+            if (!PyUnicode_Check(expr)) {
+                PyErr_Format(PyExc_TypeError, "expression %zd is not a str", base + (Py_ssize_t)i);
+                goto fail;
+            }
+            items[i].expr = PyUnicode_AsUTF8AndSize(expr, &items[i].len);
+            if (!items[i].expr)
+                goto fail;
+        }
+
+        Py_BEGIN_ALLOW_THREADS
+        evaluate_block(items, count, threads);
+        Py_END_ALLOW_THREADS
+
+        for (size_t i = 0; i < count; i++) {
+            PyObject* value;
+            if (items[i].error) {
+                value = Py_None;
+                Py_INCREF(value);
+            }
+            else {
+                value = PyUnicode_FromStringAndSize(items[i].out, (Py_ssize_t)items[i].out_len);
+                if (!value)
+                    goto fail;
+            }
+            PyList_SET_ITEM(results, base + (Py_ssize_t)i, value);
+        }
+    }
+
+    PyMem_RawFree(items);
+    Py_DECREF(tuple);
+    return results;
+
+fail:
+    PyMem_RawFree(items);
+    Py_XDECREF(results);
+    Py_DECREF(tuple);
+    return NULL;
+}
+
+// Find a loaded rule set, loading it when it is not in memory yet: a name
+// ending in .json is a rule file, anything else a rule name as given to
+// ccal -m converter. Returns NULL with an exception set on failure.
+static ccal_rules* load_rules(const char* name) {
+    for (int i = 0; i < loaded_count; i++) {
+        if (strcmp(loaded_rules[i].name, name) == 0)
+            return loaded_rules[i].rules;
+    }
+
+    size_t len = strlen(name);
+    ccal_rules* rules = NULL;
+    if (len < sizeof(loaded_rules[0].name)) {
+        if (len > 5 && strcmp(name + len - 5, ".json") == 0)
+            rules = ccal_rules_load_file(name);
+        else
+            rules = ccal_rules_load(name);
+    }
+    if (!rules) {
+        PyErr_Format(CcalError, "Failed to load conversion rules for '%s'", name);
+        return NULL;
+    }
+
+    // Keep the most recent sets, dropping the oldest when full
+    if (loaded_count == PY_CCAL_MAX_RULES) {
+        ccal_rules_free(loaded_rules[0].rules);
+        memmove(&loaded_rules[0], &loaded_rules[1], sizeof(PyCcalRule) * (PY_CCAL_MAX_RULES - 1));
+        loaded_count--;
+    }
+    strcpy(loaded_rules[loaded_count].name, name);
+    loaded_rules[loaded_count].rules = rules;
+    loaded_count++;
+    return rules;
+}
+
+// convert(value, from_unit, to_unit, rule=None) -> float
+static PyObject* py_convert(PyObject* self, PyObject* args, PyObject* kwds) {
+    (void)self;
+    static char* kwlist[] = { "value", "from_unit", "to_unit", "rule", NULL };
+    double value, result;
+    const char* from_unit;
+    const char* to_unit;
+    const char* rule_name = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "dss|z:convert", kwlist,
+                                     &value, &from_unit, &to_unit, &rule_name))
+        return NULL;
+    if (rule_name == NULL) {
+        rule_name = ccal_rules_detect(from_unit, to_unit);
+        if (rule_name == NULL) {
+            PyErr_Format(CcalError, "Could not auto-detect rule for units '%s' and '%s'",
+                         from_unit, to_unit);
+            return NULL;
+        }
+    }
+
+    ccal_rules* rules = load_rules(rule_name);
+    if (!rules)
+        return NULL;
+    switch (ccal_convert(rules, value, from_unit, to_unit, &result)) {
+    case CCAL_CONVERT_OK:
+        return PyFloat_FromDouble(result);
+    case CCAL_CONVERT_UNKNOWN_FROM:
+        PyErr_Format(CcalError, "Unknown unit '%s'", from_unit);
+        return NULL;
+    case CCAL_CONVERT_UNKNOWN_TO:
+        PyErr_Format(CcalError, "Unknown target unit '%s'", to_unit);
+        return NULL;
+    default:
+        PyErr_SetString(CcalError, "Conversion not defined");
+        return NULL;
+    }
+}
+
+static PyMethodDef ccal_methods[] = {
+    { "evaluate", py_evaluate, METH_O,
+      "evaluate(expr) -> str\n\n"
+      "Evaluate an expression and return the result formatted like ccal -q.\n"
+      "Raises ccal.Error for an invalid expression." },
+    { "evaluate_many", (PyCFunction)(void (*)(void))py_evaluate_many, METH_VARARGS | METH_KEYWORDS,
+      "evaluate_many(exprs, threads=0) -> list\n\n"
+      "Evaluate a sequence of expressions without holding the GIL, on up to\n"
+      "threads native threads (0 uses every core). Results come back in\n"
+      "input order, with None for each invalid expression." },
+    { "convert", (PyCFunction)(void (*)(void))py_convert, METH_VARARGS | METH_KEYWORDS,
+      "convert(value, from_unit, to_unit, rule=None) -> float\n\n"
+      "Convert value between units of a rule set, given by name like\n"
+      "ccal -m converter or as a path to a .json rule file. Without a rule\n"
+      "it is detected, which needs a build with embedded rules.\n"
+      "Raises ccal.Error if the rules or units are unknown." },
+    { NULL, NULL, 0, NULL }
+};
+
+static struct PyModuleDef ccal_module = {
+    PyModuleDef_HEAD_INIT,
+    "ccal",
+    "In-process interface to the ccal calculator and unit converter.",
+    -1,
+    ccal_methods,
+    NULL, NULL, NULL, NULL
+};
+
+PyMODINIT_FUNC PyInit_ccal(void) {
+    PyObject* m = PyModule_Create(&ccal_module);
+    if (!m)
+        return NULL;
+    CcalError = PyErr_NewException("ccal.Error", PyExc_ValueError, NULL);
+    if (!CcalError || PyModule_AddObject(m, "Error", CcalError) < 0) {
+        Py_XDECREF(CcalError);
+        Py_DECREF(m);
+        return NULL;
+    }
+    Py_INCREF(CcalError);  // the module's reference was stolen above
+    return m;
+}
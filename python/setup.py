@@ -0,0 +1,35 @@
+"""Build the ccal CPython extension module.
+
+From the repository root:
+
+    python3 python/setup.py build_ext --inplace
+
+Set CFLAGS=-DUSE_EMBEDDED_RULES (after running build_rules.sh) to compile
+the conversion rules in.
+"""
+
+import os
+
+from setuptools import Extension, setup
+
+REPO_ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+setup(
+    name="ccal",
+    version="2.0.0",
+    description="In-process interface to the ccal calculator",
+    ext_modules=[
+        Extension(
+            "ccal",
+            sources=[
+                os.path.join(REPO_ROOT, "python", "ccalmodule.c"),
+                os.path.join(REPO_ROOT, "ccal.c"),
+                os.path.join(REPO_ROOT, "modules", "converter.c"),
+            ],
+            define_macros=[("CCAL_LIBRARY", None)],
+            extra_compile_args=["-pthread"],
+            extra_link_args=["-pthread"],
+            libraries=["m"],
+        )
+    ],
+)
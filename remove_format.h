@@ -4,7 +4,10 @@
 #ifndef REMOVE_FORMAT_H
 #define REMOVE_FORMAT_H
 
+#include "ccal.h"
+
 // Global variables.
+// Mirror the default context used by the functions below.
 // Formats calculated number according to if decimal exists in any 
 // formula digits.
 extern int hasDec; 
@@ -16,5 +19,7 @@ extern int maxDecLocal;
 void remove_format(char* str);
 void max_decimals(int* num);
 void FormatOutput(const char* expr, double result, char* fin_str);
+int expr_cache_enable(size_t max_bytes);
+const ccal_cache* expr_cache_stats(void);
 
 #endif
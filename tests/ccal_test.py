@@ -6,10 +6,19 @@ validate numeric output formatting and expression handling.
 
 import argparse
 import contextlib
+import ctypes
+import importlib.util
 import io
+import json
 import os
+import shutil
+import signal
+import socket
 import subprocess
 import sys
+import sysconfig
+import tempfile
+import time
 import unittest
 
 REPO_ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
@@ -22,8 +31,16 @@ def _build_cli_executable() -> str:
     compile_cmd = [
         "gcc",
         "ccal.c",
+        "modules/converter.c",
+        "modules/batch.c",
+        "modules/serve.c",
+        "modules/shm.c",
+        "modules/repl.c",
+        "modules/latency.c",
         "-o",
         exe_path,
+        "-pthread",
+        "-lm",
     ]
     result = subprocess.run(
         compile_cmd,
@@ -142,6 +159,10 @@ CLI_SUCCESS_CASES = [
     ),
     ("power_operator", ["2", "p", "2"], "4"),
     ("power_quote_caret", ["--quote", "2^2"], "4"),
+    ("power_negative_exponent", ["2", "p", "-2"], "0.25"),
+    ("power_fractional_exponent", ["--quote", "2^0.5"], "1.41"),
+    ("power_zero_exponent_negative_base", ["--quote", "(-2)^0"], "1"),
+    ("power_large_exponent", ["--quote", "1^100000000000"], "1"),
     ("quote_commas", ["--quote", "2,000-1,000"], "1000"),
     ("manual_commas", ["2,000", "-", "1,000"], "1000"),
     ("decimal_precision_three", ["--quote", "1+1.001"], "2.001"),
@@ -156,8 +177,20 @@ CLI_SUCCESS_CASES = [
     ("small_decimal_sum", ["--quote", "0.3330+0.0005"], "0.3335"),
     ("currency_input", ["--quote", "$1,234.5678+1"], "1235.5678"),
     ("asterisk_with_quote", ["--quote", "(2+3)*4"], "20"),
+    ("format_large_exponent", ["--quote", "2^60"], "1.152921504606847e+18"),
+    ("format_small_exponent", ["--quote", "1/100000"], "1e-05"),
+    ("format_sixteen_digits", ["--quote", "-1/3"], "-0.3333333333333333"),
+    ("format_fixed_rounding", ["--quote", "0.1+0.2"], "0.30"),
+    ("exact_ledger_sum", ["--quote", "90071992547409.93+0.01"], "90071992547409.94"),
+    ("exact_beyond_double", ["9007199254740993", "+", "0"], "9007199254740993"),
+    ("exact_half_even", ["--quote", "68.5109/2"], "34.2554"),
+    ("argv_left_to_right", ["2", "+", "3", "x", "4"], "20"),
+    ("argv_long_command", ["1"] + ["+", "0.5"] * 40, "21"),
+    ("argv_formatted_operand", ["$1,000", "+", "0.5"], "1000.50"),
 ]
 
+BATCH_ERROR = "Error: Invalid expression"
+
 
 class CLITestExamples(unittest.TestCase):
     """Execute README CLI scenarios."""
@@ -169,10 +202,11 @@ class CLITestExamples(unittest.TestCase):
         except RuntimeError as exc:
             raise unittest.SkipTest(str(exc)) from exc
 
-    def _run_cli(self, args):
+    def _run_cli(self, args, stdin_text=None):
         return subprocess.run(
             [self.exe_path, *args],
             cwd=REPO_ROOT,
+            input=stdin_text,
             stdout=subprocess.PIPE,
             stderr=subprocess.PIPE,
             text=True,
@@ -190,6 +224,671 @@ class CLITestExamples(unittest.TestCase):
                 self.assertEqual(proc.stdout.strip(), expected)
                 self.assertEqual(proc.stderr.strip(), "")
 
+    def test_batch_matches_quote_mode(self):
+        quoted = [args[1] for _, args, _ in CLI_SUCCESS_CASES
+                  if args[0] == "--quote"]
+        expected = [exp for _, args, exp in CLI_SUCCESS_CASES
+                    if args[0] == "--quote"]
+        proc = self._run_cli(["--batch"], "\n".join(quoted) + "\n")
+        self.assertEqual(proc.returncode, 0, msg=proc.stderr.strip())
+        self.assertEqual(proc.stdout.splitlines(), expected)
+
+    def test_batch_threads_keep_order(self):
+        lines = [f"{i}x3-1" if i % 7 else f"{i}/0" for i in range(5000)]
+        expected = [str(i * 3 - 1) if i % 7 else BATCH_ERROR
+                    for i in range(5000)]
+        proc = self._run_cli(["--batch", "--threads", "4"],
+                             "\n".join(lines) + "\n")
+        self.assertEqual(proc.returncode, 1)
+        self.assertEqual(proc.stdout.splitlines(), expected)
+
+    def test_batch_error_marker(self):
+        proc = self._run_cli(["--batch", "-"], "1+1\n1/0\n\n3x4\r\n")
+        self.assertEqual(proc.returncode, 1)
+        self.assertEqual(
+            proc.stdout.splitlines(),
+            ["2", BATCH_ERROR, BATCH_ERROR, "12"],
+        )
+
+    def test_batch_deep_nesting(self):
+        lines = [
+            "(" * 5000 + "2" + ")" * 5000,
+            "-" * 9999 + "5",
+            "[" * 1000000 + "1" + "]" * 1000000,
+            "-" * 1000000 + "5",
+        ]
+        proc = self._run_cli(["--batch"], "\n".join(lines) + "\n")
+        self.assertEqual(proc.returncode, 1)
+        self.assertEqual(
+            proc.stdout.splitlines(),
+            ["2", "-5", BATCH_ERROR, BATCH_ERROR],
+        )
+
+    def test_batch_cache_stats(self):
+        lines = ["2,000 x 1.5", "(1 + 2) x 3", "2000x1.5", "( 1+2 )x 3", "0x1 0", "0 x10"]
+        proc = self._run_cli(["--batch", "--cache", "1", "--cache-stats"], "\n".join(lines) + "\n")
+        self.assertEqual(proc.returncode, 1)
+        self.assertEqual(proc.stdout.splitlines(), ["3000", "9", "3000", "9", BATCH_ERROR, "0"])
+        self.assertEqual(proc.stderr.strip(), "Cache: 2 hits, 4 misses, 0 evictions")
+
+    @unittest.skipUnless(sys.platform.startswith("linux"), "server mode needs epoll")
+    def test_serve_persistent_connections(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            path = os.path.join(tmp, "ccal.sock")
+            server = subprocess.Popen(
+                [self.exe_path, "--serve", path],
+                cwd=REPO_ROOT,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            try:
+                deadline = time.monotonic() + 5
+                while not os.path.exists(path) and time.monotonic() < deadline:
+                    time.sleep(0.01)
+
+                first = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+                second = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+                first.connect(path)
+                second.connect(path)
+                first_in = first.makefile("r")
+                second_in = second.makefile("r")
+
+                first.sendall(b"2,000 x 1.5\n1/0\n")
+                second.sendall(b"-m converter length 10 in cm\r\n")
+                self.assertEqual(first_in.readline(), "3000\n")
+                self.assertEqual(first_in.readline(), BATCH_ERROR + "\n")
+                self.assertEqual(second_in.readline(), "10.000000 in = 25.400000 cm\n")
+
+                second.sendall(b"-m converter length 1 parsec cm\n(1 + 2")
+                second.shutdown(socket.SHUT_WR)
+                self.assertEqual(second_in.readline(), "Error: Unknown unit 'parsec'\n")
+                self.assertEqual(second_in.readline(), BATCH_ERROR + "\n")
+                self.assertEqual(second_in.readline(), "")
+
+                first.sendall(b"0.1 + 0.2\n")
+                self.assertEqual(first_in.readline(), "0.30\n")
+                first.close()
+                second.close()
+            finally:
+                server.terminate()
+                server.wait(timeout=5)
+            self.assertEqual(server.returncode, 0)
+            self.assertFalse(os.path.exists(path))
+
+    def _latency_table(self, text):
+        rows = {}
+        for line in text.splitlines()[1:]:
+            name, count, *values = line.split()
+            rows[name] = (int(count), [float(v) for v in values])
+        return rows
+
+    @unittest.skipUnless(sys.platform.startswith("linux"), "server mode needs epoll")
+    def test_serve_evicts_oldest_rules(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            rules_dir = os.path.join(tmp, "rules", "converter")
+            os.makedirs(rules_dir)
+            names = ["length%d" % i for i in range(20)]
+            for name in names:
+                shutil.copy(os.path.join(REPO_ROOT, "rules", "converter", "length.json"),
+                            os.path.join(rules_dir, name + ".json"))
+            path = os.path.join(tmp, "ccal.sock")
+            server = subprocess.Popen([self.exe_path, "--serve", path], cwd=tmp)
+            try:
+                deadline = time.monotonic() + 5
+                while not os.path.exists(path) and time.monotonic() < deadline:
+                    time.sleep(0.01)
+                client = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+                client.connect(path)
+                reader = client.makefile("r")
+                # More rule sets than the server keeps, then the first again
+                for name in names + names[:1]:
+                    client.sendall(b"-m converter %s 10 in cm\n" % name.encode())
+                    self.assertEqual(reader.readline(), "10.000000 in = 25.400000 cm\n")
+                reader.close()
+                client.close()
+            finally:
+                server.terminate()
+                server.wait(timeout=5)
+            self.assertEqual(server.returncode, 0)
+
+    def test_batch_latency_histograms(self):
+        lines = ["2,000 x 1.5", "(1 + 2) x 3", "1/0"] * 400
+        for threads in ("1", "3"):
+            with self.subTest(threads=threads):
+                proc = self._run_cli(["--batch", "--threads", threads, "--latency"], "\n".join(lines) + "\n")
+                self.assertEqual(proc.returncode, 1)
+                self.assertEqual(proc.stdout.splitlines()[:3], ["3000", "9", BATCH_ERROR])
+                self.assertRegex(proc.stderr.splitlines()[0], r"^Latency \(ns\)\s+count\s+p50\s+p99\s+p999\s+max$")
+                rows = self._latency_table(proc.stderr)
+                self.assertEqual(sorted(rows), ["evaluate", "format"])
+                self.assertEqual(rows["evaluate"][0], 1200)
+                self.assertEqual(rows["format"][0], 800)
+                for _, values in rows.values():
+                    self.assertEqual(values, sorted(values))
+
+    def test_latency_bucket_bounds(self):
+        driver = r"""
+#include <stdio.h>
+#include "modules/latency.h"
+int main(void) {
+    const uint64_t ticks[] = { 255, 256, (1ull << 44) - 1, 1ull << 44, (1ull << 45) - 1, UINT64_MAX };
+    printf("%d\n", LATENCY_BUCKETS);
+    for (int i = 0; i < 6; i++)
+        printf("%d\n", latency_bucket(ticks[i]));
+    return 0;
+}
+"""
+        with tempfile.TemporaryDirectory() as tmp:
+            src = os.path.join(tmp, "bucket.c")
+            exe = os.path.join(tmp, "bucket")
+            with open(src, "w") as f:
+                f.write(driver)
+            build = subprocess.run(
+                ["gcc", "-I" + REPO_ROOT, src, "-o", exe],
+                cwd=REPO_ROOT,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            self.assertEqual(build.returncode, 0, build.stderr)
+            proc = subprocess.run([exe], stdout=subprocess.PIPE, text=True)
+        self.assertEqual(proc.returncode, 0)
+        buckets, *indexes = (int(line) for line in proc.stdout.split())
+        # Everything from 2^44 ticks up lands in the last bucket
+        self.assertEqual(indexes, [255, 256] + [buckets - 1] * 4)
+
+    @unittest.skipUnless(sys.platform.startswith("linux"), "server mode needs epoll")
+    def test_serve_latency_on_signal(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            path = os.path.join(tmp, "ccal.sock")
+            server = subprocess.Popen(
+                [self.exe_path, "--serve", path, "--latency"],
+                cwd=REPO_ROOT,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            try:
+                deadline = time.monotonic() + 5
+                while not os.path.exists(path) and time.monotonic() < deadline:
+                    time.sleep(0.01)
+                client = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+                client.connect(path)
+                reader = client.makefile("r")
+                client.sendall(b"1 + 1\n-m converter length 10 in cm\n")
+                self.assertEqual(reader.readline(), "2\n")
+                self.assertEqual(reader.readline(), "10.000000 in = 25.400000 cm\n")
+
+                server.send_signal(signal.SIGUSR1)
+                self.assertTrue(server.stderr.readline().startswith("Latency (ns)"))
+                rows = self._latency_table("\n" + server.stderr.readline() + server.stderr.readline()
+                                           + server.stderr.readline())
+                self.assertEqual({name: count for name, (count, _) in rows.items()},
+                                 {"evaluate": 1, "format": 1, "convert": 1})
+                reader.close()
+                client.close()
+            finally:
+                server.terminate()
+                server.wait(timeout=5)
+            self.assertEqual(server.returncode, 0)
+            # The final table follows at exit
+            self.assertTrue(server.stderr.read().startswith("Latency (ns)"))
+            server.stderr.close()
+
+    @unittest.skipUnless(sys.platform.startswith("linux"), "shared memory server needs POSIX shm")
+    def test_shm_client_library(self):
+        class ShmClient(ctypes.Structure):
+            _fields_ = [
+                ("seg", ctypes.c_void_p),
+                ("req_tail", ctypes.c_uint32),
+                ("req_head", ctypes.c_uint32),
+                ("resp_head", ctypes.c_uint32),
+                ("resp_tail", ctypes.c_uint32),
+            ]
+
+        with tempfile.TemporaryDirectory() as tmp:
+            lib_path = os.path.join(tmp, "libccal_shm.so")
+            build = subprocess.run(
+                ["gcc", "-shared", "-fPIC", "modules/shm_client.c", "-o", lib_path],
+                cwd=REPO_ROOT,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            self.assertEqual(build.returncode, 0, build.stderr)
+            lib = ctypes.CDLL(lib_path)
+
+            name = "ccal-test-%d" % os.getpid()
+            server = subprocess.Popen(
+                [self.exe_path, "--shm", name],
+                cwd=REPO_ROOT,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            try:
+                client = ShmClient()
+                deadline = time.monotonic() + 5
+                while not lib.ccal_shm_connect(ctypes.byref(client), name.encode()):
+                    self.assertLess(time.monotonic(), deadline)
+                    time.sleep(0.01)
+                other = ShmClient()
+                self.assertEqual(lib.ccal_shm_connect(ctypes.byref(other), name.encode()), 0)
+
+                out = ctypes.create_string_buffer(256)
+                error = ctypes.c_int()
+                for expr in (b"2,000 x 1.5", b"1/0", b"0.1+0.2"):
+                    self.assertEqual(lib.ccal_shm_submit(ctypes.byref(client), expr, len(expr)), 1)
+                results = []
+                while len(results) < 3:
+                    if lib.ccal_shm_receive(ctypes.byref(client), out, len(out), ctypes.byref(error)):
+                        results.append((out.value.decode(), error.value))
+                self.assertEqual(results, [("3000", 0), (BATCH_ERROR, 1), ("0.30", 0)])
+
+                self.assertEqual(lib.ccal_shm_submit(ctypes.byref(client), b"1" * 300, 300), -1)
+                lib.ccal_shm_disconnect(ctypes.byref(client))
+                self.assertEqual(lib.ccal_shm_connect(ctypes.byref(other), name.encode()), 1)
+                self.assertEqual(
+                    lib.ccal_shm_evaluate(ctypes.byref(other), b"(1 + 2) x 3", 11,
+                                          out, len(out), ctypes.byref(error)),
+                    1,
+                )
+                self.assertEqual(out.value, b"9")
+                lib.ccal_shm_disconnect(ctypes.byref(other))
+
+                # A client that exits without disconnecting, with a request
+                # still queued, does not keep the segment
+                crash = subprocess.run(
+                    [sys.executable, "-c",
+                     "import ctypes, os, sys\n"
+                     "lib = ctypes.CDLL(sys.argv[1])\n"
+                     "cl = ctypes.create_string_buffer(64)\n"
+                     "assert lib.ccal_shm_connect(cl, sys.argv[2].encode()) == 1\n"
+                     "assert lib.ccal_shm_submit(cl, b'7 x 6', 5) == 1\n"
+                     "os._exit(0)\n",
+                     lib_path, name],
+                    stderr=subprocess.PIPE,
+                    text=True,
+                )
+                self.assertEqual(crash.returncode, 0, crash.stderr)
+                self.assertEqual(lib.ccal_shm_connect(ctypes.byref(client), name.encode()), 1)
+                self.assertEqual(lib.ccal_shm_connect(ctypes.byref(other), name.encode()), 0)
+                self.assertEqual(
+                    lib.ccal_shm_evaluate(ctypes.byref(client), b"2 ^ 10", 6,
+                                          out, len(out), ctypes.byref(error)),
+                    1,
+                )
+                self.assertEqual(out.value, b"1024")
+                lib.ccal_shm_disconnect(ctypes.byref(client))
+            finally:
+                server.terminate()
+                server.wait(timeout=5)
+            self.assertEqual(server.returncode, 0)
+
+    def test_library_api_is_silent(self):
+        script = """
+import ctypes, sys
+lib = ctypes.CDLL(sys.argv[1])
+assert not hasattr(lib, "evaluate_expr_string")
+lib.ccal_rules_load.restype = ctypes.c_void_p
+lib.ccal_rules_load_file.restype = ctypes.c_void_p
+ctx = ctypes.create_string_buffer(4096)
+lib.ccal_ctx_init(ctx)
+error = ctypes.c_int()
+out = ctypes.create_string_buffer(96)
+lib.ccal_evaluate.restype = ctypes.c_double
+for expr in (b"2,000 x 1.5", b"1/0", b"(1 +"):
+    value = lib.ccal_evaluate(ctx, expr, ctypes.byref(error))
+    if not error.value:
+        lib.ccal_format_output(ctx, expr, ctypes.c_double(value), out)
+    print(error.value, out.value.decode() if not error.value else "")
+rules = ctypes.c_void_p(lib.ccal_rules_load(b"length"))
+result = ctypes.c_double()
+for src, dst in ((b"inch", b"cm"), (b"parsec", b"cm"), (b"in", b"au")):
+    status = lib.ccal_convert(rules, ctypes.c_double(10), src, dst, ctypes.byref(result))
+    print(status, "%.6f" % result.value if status == 0 else "")
+print(lib.ccal_rules_load(b"../length"), lib.ccal_rules_load_file(b"missing.json"))
+lib.ccal_rules_free(rules)
+lib.ccal_ctx_free(ctx)
+"""
+        with tempfile.TemporaryDirectory() as tmp:
+            lib_path = os.path.join(tmp, "libccal.so")
+            build = subprocess.run(
+                ["gcc", "-shared", "-fPIC", "-fvisibility=hidden", "-DCCAL_LIBRARY",
+                 "ccal.c", "modules/converter.c", "-o", lib_path, "-lm"],
+                cwd=REPO_ROOT,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            self.assertEqual(build.returncode, 0, build.stderr)
+            proc = subprocess.run(
+                [sys.executable, "-c", script, lib_path],
+                cwd=REPO_ROOT,
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+        # Only the script's own prints: failed loads and conversions
+        # report through return values, never on stdout or stderr
+        self.assertEqual(proc.stderr, "")
+        self.assertEqual(
+            proc.stdout.splitlines(),
+            ["0 3000", "1 ", "1 ", "0 25.400000", "1 ", "2 ", "None None"],
+        )
+
+    def test_python_extension_matches_batch(self):
+        include = sysconfig.get_paths()["include"]
+        if not os.path.exists(os.path.join(include, "Python.h")):
+            self.skipTest("needs the Python development headers")
+        with tempfile.TemporaryDirectory() as tmp:
+            ext_path = os.path.join(tmp, "ccal" + sysconfig.get_config_var("EXT_SUFFIX"))
+            build = subprocess.run(
+                ["gcc", "-shared", "-fPIC", "-DCCAL_LIBRARY",
+                 "-I" + include,
+                 "python/ccalmodule.c", "ccal.c", "modules/converter.c",
+                 "-o", ext_path, "-pthread", "-lm"],
+                cwd=REPO_ROOT,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            self.assertEqual(build.returncode, 0, build.stderr)
+            spec = importlib.util.spec_from_file_location("ccal", ext_path)
+            ext = importlib.util.module_from_spec(spec)
+            spec.loader.exec_module(ext)
+
+        quoted = [args[1] for _, args, _ in CLI_SUCCESS_CASES if args[0] == "--quote"]
+        lines = quoted + [f"{i}x3-1" if i % 7 else f"{i}/0" for i in range(5000)]
+        proc = self._run_cli(["--batch"], "\n".join(lines) + "\n")
+        expected = [None if out == BATCH_ERROR else out for out in proc.stdout.splitlines()]
+        self.assertEqual(ext.evaluate_many(lines), expected)
+        self.assertEqual(ext.evaluate_many(lines, threads=4), expected)
+        self.assertEqual(ext.evaluate_many([]), [])
+
+        self.assertEqual(ext.evaluate("2,000 x 1.5"), "3000")
+        with self.assertRaises(ext.Error):
+            ext.evaluate("1/0")
+        with self.assertRaises(TypeError):
+            ext.evaluate_many(["1+1", 2])
+
+        cwd = os.getcwd()
+        os.chdir(REPO_ROOT)
+        try:
+            self.assertAlmostEqual(ext.convert(10, "inch", "cm", "length"), 25.4)
+            with self.assertRaisesRegex(ext.Error, "Unknown target unit"):
+                ext.convert(10, "inch", "parsec", "length")
+        finally:
+            os.chdir(cwd)
+
+    def test_repl_chains_previous_result(self):
+        lines = [
+            "2,000 x 1.5", "x 2", "ans / 4 + ans", "", "1/0", "-2", "^2",
+            "clear", "ans", "-m converter length 10 inch cm", "2 ^ ans", "quit", "1+1",
+        ]
+        proc = self._run_cli(["--repl"], "\n".join(lines) + "\n")
+        self.assertEqual(proc.returncode, 0)
+        results = [line.rsplit("  (", 1)[0] for line in proc.stdout.splitlines()]
+        self.assertEqual(
+            results,
+            ["3000", "6000", "7500", BATCH_ERROR, "-2", "4", BATCH_ERROR, "10.000000 in = 25.400000 cm", BATCH_ERROR],
+        )
+        for line in proc.stdout.splitlines():
+            self.assertRegex(line, r"  \(\d+\.\d+ [um]s\)$")
+
+    def test_repl_chains_full_precision(self):
+        # The previous result is carried as a value, not as the rounded text
+        # printed for it
+        lines = ["2^60", "x 2", "- 2305843009213693951", "1.5/7", "x 7", "ans - 1.5"]
+        proc = self._run_cli(["--repl"], "\n".join(lines) + "\n")
+        self.assertEqual(proc.returncode, 0)
+        results = [line.rsplit("  (", 1)[0] for line in proc.stdout.splitlines()]
+        self.assertEqual(results[2:], ["1", "0.21", "1.50", "0"])
+
+    @unittest.skipUnless(sys.platform.startswith("linux"), "reads a directory as stdin")
+    def test_repl_stops_on_read_error(self):
+        fd = os.open("/", os.O_RDONLY)
+        try:
+            proc = subprocess.run(
+                [self.exe_path, "--repl"],
+                stdin=fd,
+                stdout=subprocess.PIPE,
+                text=True,
+                timeout=10,
+            )
+        finally:
+            os.close(fd)
+        self.assertEqual(proc.returncode, 0)
+        self.assertEqual(proc.stdout, "")
+
+    def test_incremental_edits_match_batch(self):
+        driver = r"""
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ccal.h"
+#include "modules/incremental.h"
+int main(void) {
+    ccal_incr inc;
+    static char line[1 << 17];
+    char out[CCAL_RESULT_MAX];
+    ccal_incr_init(&inc);
+    while (fgets(line, sizeof(line), stdin)) {
+        char* rest;
+        size_t pos = strtoul(line, &rest, 10);
+        size_t del = strtoul(rest, &rest, 10);
+        size_t ins = strcspn(++rest, "\n");
+        int error;
+        if (!ccal_incr_edit(&inc, pos, del, rest, ins))
+            return 1;
+        ccal_result res = ccal_incr_result(&inc, &error);
+        if (error)
+            puts("Error: Invalid expression");
+        else {
+            out[ccal_write_result(&res, 0, out)] = '\0';
+            puts(out);
+        }
+        fprintf(stderr, "%zu %zu %d\n", inc.lexed, inc.folded, inc.count);
+    }
+    ccal_incr_free(&inc);
+    return 0;
+}
+"""
+        # Typing a formula, then editing inside it, as an editor would
+        edits = [(i, 0, c) for i, c in enumerate("(1.5 + 2) x 3")]
+        edits += [
+            (1, 3, "10"), (4, 1, "-"), (0, 0, "["), (13, 0, " ^ 2]"), (1, 1, ""),
+            (0, 0, "4 / "), (4, 1, "{"), (4, 1, "("), (4, 0, "-"), (7, 0, "2,00"),
+            (0, 0, "1 + 2 x 3 - "), (28, 6, ""), (0, 60, "7 / (3 - 3)"), (9, 1, "2"),
+        ]
+        with tempfile.TemporaryDirectory() as tmp:
+            src = os.path.join(tmp, "incr.c")
+            exe = os.path.join(tmp, "incr")
+            with open(src, "w") as f:
+                f.write(driver)
+            build = subprocess.run(
+                ["gcc", "-DCCAL_LIBRARY", "-I" + REPO_ROOT, src, "ccal.c",
+                 "modules/incremental.c", "-o", exe, "-lm"],
+                cwd=REPO_ROOT,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            self.assertEqual(build.returncode, 0, build.stderr)
+            proc = subprocess.run(
+                [exe],
+                input="".join(f"{pos} {dele} {ins}\n" for pos, dele, ins in edits),
+                stdout=subprocess.PIPE,
+                stderr=subprocess.DEVNULL,
+                text=True,
+            )
+            # One digit changed in the middle of a 10,000 term formula
+            formula = " + ".join(f"{i % 9 + 1} x 2" for i in range(10000))
+            middle = formula.index("5 x 2", len(formula) // 2)
+            long_proc = subprocess.run(
+                [exe],
+                input=f"0 0 {formula}\n{middle} 1 7\n",
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+        self.assertEqual(proc.returncode, 0)
+
+        texts = []
+        text = ""
+        for pos, dele, ins in edits:
+            pos = min(pos, len(text))
+            text = text[:pos] + ins + text[pos + dele:]
+            texts.append(text)
+        expected = self._run_cli(["--batch"], "\n".join(texts) + "\n").stdout.splitlines()
+        self.assertEqual(proc.stdout.splitlines(), expected)
+        self.assertIn("Error: Invalid expression", expected)
+
+        # The edit lexes only the changed token and folds a fraction of them
+        self.assertEqual(long_proc.returncode, 0)
+        edited = formula[:middle] + "7" + formula[middle + 1:]
+        self.assertEqual(long_proc.stdout.splitlines(),
+                         self._run_cli(["--batch"], formula + "\n" + edited + "\n").stdout.splitlines())
+        lexed, folded, count = map(int, long_proc.stderr.splitlines()[-1].split())
+        self.assertEqual(lexed, 1)
+        self.assertLess(folded, count // 4)
+
+    def test_bench_reports_json(self):
+        with tempfile.TemporaryDirectory() as tmp:
+            exe = os.path.join(tmp, "ccal_bench")
+            build = subprocess.run(
+                ["gcc", "-O2", "-DCCAL_LIBRARY", "bench/ccal_bench.c", "ccal.c",
+                 "modules/converter.c", "-o", exe, "-lm"],
+                cwd=REPO_ROOT,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            self.assertEqual(build.returncode, 0, build.stderr)
+            quick = ["--time", "1", "--repeat", "1", "--corpus", "64"]
+            proc = subprocess.run(
+                [exe, *quick, "--json", "-"],
+                cwd=REPO_ROOT,
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            self.assertEqual(proc.returncode, 0, proc.stderr)
+            report = json.loads(proc.stdout)
+            names = [b["name"] for b in report["benchmarks"]]
+            for name in ("evaluate_expr_string", "evaluate_argv", "FormatOutput", "remove_format",
+                         "load_conversion_rules", "find_unit_by_name", "convert_unit"):
+                self.assertIn(name, names)
+            for bench in report["benchmarks"]:
+                self.assertGreater(bench["ns_per_op"], 0)
+
+            # Against a baseline ten times faster every benchmark regressed
+            baseline = os.path.join(tmp, "baseline.json")
+            for bench in report["benchmarks"]:
+                bench["ns_per_op"] /= 10
+            with open(baseline, "w") as f:
+                json.dump(report, f, indent=0)
+            proc = subprocess.run(
+                [exe, *quick, "--filter", "unit", "--baseline", baseline],
+                cwd=REPO_ROOT,
+                stdout=subprocess.PIPE,
+                text=True,
+            )
+            self.assertEqual(proc.returncode, 3)
+            self.assertEqual(proc.stdout.count("SLOWER"), 2)
+
+    def test_trace_stats_counts_parser_work(self):
+        proc = self._run_cli(["--trace-stats", "1", "+", "1"])
+        self.assertEqual(proc.returncode, 1)
+        self.assertIn("-DCCAL_TRACE", proc.stderr)
+
+        with tempfile.TemporaryDirectory() as tmp:
+            exe = os.path.join(tmp, "ccal_trace")
+            build = subprocess.run(
+                ["gcc", "-DCCAL_TRACE", "ccal.c", "modules/converter.c", "modules/batch.c",
+                 "modules/serve.c", "modules/shm.c", "modules/repl.c", "modules/latency.c",
+                 "-o", exe, "-pthread", "-lm"],
+                cwd=REPO_ROOT,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+            self.assertEqual(build.returncode, 0, build.stderr)
+            proc = subprocess.run(
+                [exe, "--trace-stats", "--batch"],
+                cwd=REPO_ROOT,
+                input="((1 + 2) x -3)\n" + "(" * 40 + "1" + ")" * 40 + "\n",
+                stdout=subprocess.PIPE,
+                stderr=subprocess.PIPE,
+                text=True,
+            )
+        self.assertEqual(proc.returncode, 0)
+        self.assertEqual(proc.stdout.splitlines(), ["-9", "1"])
+        counts = dict((name, int(count)) for name, count in
+                      (line.split() for line in proc.stderr.splitlines()[1:]))
+        self.assertEqual(counts["operand"], 4)
+        self.assertEqual(counts["open"], 43)
+        self.assertEqual(counts["shift"], 2)
+        self.assertEqual(counts["reduce"], 2)
+        self.assertEqual(counts["max_depth"], 40)
+        self.assertEqual(counts["convert"], 0)
+
+    def test_usdt_probes_in_binary(self):
+        probe = subprocess.run(
+            ["gcc", "-E", "-x", "c", "-"],
+            input="#include <sys/sdt.h>\n",
+            stdout=subprocess.DEVNULL,
+            stderr=subprocess.DEVNULL,
+            text=True,
+        )
+        if probe.returncode != 0 or shutil.which("readelf") is None:
+            self.skipTest("needs sys/sdt.h and readelf")
+        notes = subprocess.run(
+            ["readelf", "-n", self.exe_path],
+            stdout=subprocess.PIPE,
+            text=True,
+        ).stdout
+        for name in ("expr__start", "expr__end", "parse__error", "rules__load", "convert"):
+            self.assertIn("Name: " + name, notes)
+        self.assertEqual(self._run_cli(["--quote", "2^10"]).stdout, "1024\n")
+
+    def test_argv_rejects_bad_tokens(self):
+        for args in (["(", "1", "+", "2", "]"], ["2", "*", "3"], ["2", "^", "3"],
+                     ["1", "/", "(", "2", "-", "2", ")"], ["(", "1", "+", "2"],
+                     ["5abc", "+", "1"], ["1.2.3", "+", "1"], ["abc", "+", "1"],
+                     ["5", "+", "+"], ["+", "5"], ["1", "x", ")"], ["", "+", "1"]):
+            with self.subTest(args=args):
+                proc = self._run_cli(args)
+                self.assertEqual(proc.returncode, 1)
+                self.assertEqual(proc.stdout.strip(), BATCH_ERROR)
+        # Spaces around a number are not part of what is rejected
+        for args in (["1 ", "+", "2"], [" 1", "+", "2"], ["1,\t", "+", "$2"]):
+            with self.subTest(args=args):
+                proc = self._run_cli(args)
+                self.assertEqual(proc.returncode, 0)
+                self.assertEqual(proc.stdout.strip(), "3")
+
+    def test_exact_zero_divisor(self):
+        proc = self._run_cli(["--quote", "1/(0.1+0.2-0.3)"])
+        self.assertEqual(proc.returncode, 1)
+        self.assertEqual(proc.stdout.strip(), BATCH_ERROR)
+
+    def test_columns_apply_expression_per_row(self):
+        csv_text = '10.5,2\n3,1\n"1,000.25",0\n4,n/a\n5\n'
+        proc = self._run_cli(["--columns", "($1 - $2) x 1.08"], csv_text)
+        self.assertEqual(proc.returncode, 1)
+        self.assertEqual(
+            proc.stdout.splitlines(),
+            ["9.18", "2.16", "1080.27", BATCH_ERROR, BATCH_ERROR],
+        )
+
+    def test_columns_shared_subexpressions(self):
+        expr = "[$1 x $2] + [$1 x $2] x (2 x 3 - 5) / [$1 x $2]"
+        proc = self._run_cli(["--columns", expr], "3,4\n0,1\n2.5,2\n")
+        self.assertEqual(proc.returncode, 1)
+        self.assertEqual(proc.stdout.splitlines(), ["13", BATCH_ERROR, "6"])
+
+    def test_columns_constant_zero_divisor(self):
+        proc = self._run_cli(["--columns", "$1 + 1 / (2 - 2)"], "1\n2\n")
+        self.assertEqual(proc.returncode, 1)
+        self.assertEqual(proc.stdout.splitlines(), [BATCH_ERROR, BATCH_ERROR])
+
+    def test_columns_invalid_expression(self):
+        proc = self._run_cli(["--columns", "$0 + 1"], "1\n")
+        self.assertEqual(proc.returncode, 1)
+        self.assertEqual(proc.stdout, "")
+
 
 if __name__ == "__main__":  # pragma: no cover
     parser = argparse.ArgumentParser(
@@ -0,0 +1,141 @@
+// trace.h
+// Hot-path counters and static probes for tracing ccal
+// Built with -DCCAL_TRACE, the parser and the converter count how often
+// their inner functions run and how deep brackets nest, and
+// ccal --trace-stats prints the totals; in every other build the macros
+// below expand to nothing
+// Wherever <sys/sdt.h> is installed, USDT probes are also built in for
+// bpftrace, perf and SystemTap to attach to in a running process
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#ifdef CCAL_TRACE
+
+#include <stdio.h>
+#include <stdatomic.h>
+
+#include "ccal.h"
+
+// What is counted
+enum {
+    CCAL_TRACE_SKIP_SPACES,   // skip_spaces and read_token calls
+    CCAL_TRACE_OPERAND,       // numbers read as operands
+    CCAL_TRACE_OPEN,          // open brackets and unary minuses pushed
+    CCAL_TRACE_SHIFT,         // binary operators pushed
+    CCAL_TRACE_REDUCE,        // binary operators applied
+    CCAL_TRACE_STACK_GROW,    // parse stacks moved to or grown on the heap
+    CCAL_TRACE_SCAN_NUMBER,   // scan_number calls
+    CCAL_TRACE_STRTOD,        // strtod and atof calls
+    CCAL_TRACE_TERM_EVAL,     // parse_term_eval calls (argv path)
+    CCAL_TRACE_EXPR_EVAL,     // parse_expr_eval calls (argv path)
+    CCAL_TRACE_RULE_LINE,     // rule lines read by the converter
+    CCAL_TRACE_FIND_UNIT,     // find_unit_by_name calls
+    CCAL_TRACE_ALIAS,         // unit aliases compared
+    CCAL_TRACE_FIND_TARGET,   // find_target_unit calls
+    CCAL_TRACE_CONVERT,       // convert_unit calls
+    CCAL_TRACE_COUNTERS
+};
+
+// Totals since the process started, from every thread
+CCAL_API extern _Atomic unsigned long long ccal_trace_counts[CCAL_TRACE_COUNTERS];
+
+// Deepest nesting of brackets and unary minuses seen
+CCAL_API extern _Atomic int ccal_trace_max_depth;
+
+#define CCAL_TRACE_HIT(counter) \
+    atomic_fetch_add_explicit(&ccal_trace_counts[counter], 1, memory_order_relaxed)
+
+#define CCAL_TRACE_DEPTH(depth) do { \
+    int trace_depth_ = (depth); \
+    if (trace_depth_ > atomic_load_explicit(&ccal_trace_max_depth, memory_order_relaxed)) \
+        atomic_store_explicit(&ccal_trace_max_depth, trace_depth_, memory_order_relaxed); \
+} while (0)
+
+// Function declarations
+CCAL_API void ccal_trace_print(FILE* fp);
+
+#else
+
+#define CCAL_TRACE_HIT(counter) ((void)0)
+#define CCAL_TRACE_DEPTH(depth) ((void)0)
+
+#endif // CCAL_TRACE
+
+// USDT probes of provider ccal, built in unless -DCCAL_NO_SDT is given:
+//   expr__start(len)                       an expression is evaluated
+//   expr__end(len, result, error, ns)      and done
+//   parse__error(len, offset)              where it was rejected
+//   rules__load(name, units, ok, ns)       rules were loaded
+//   convert(from, to, result, ok, ns)      convert_unit returned
+// len and offset count bytes of a quoted expression, or argv tokens.
+// result is the bit pattern of the double (bpftrace has no doubles), and
+// ns the time the call took, measured only while a tracer is attached.
+#if !defined(CCAL_NO_SDT) && defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#define CCAL_SDT 1
+#endif
+#endif
+
+#ifdef CCAL_SDT
+
+// Semaphores let a probe site see that a tracer is attached, so the clock
+// is only read while one is
+#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#define CCAL_PROBE_SEMAPHORE(name) \
+    __extension__ extern unsigned short ccal_##name##_semaphore \
+    __attribute__((unused)) __attribute__((section(".probes")))
+
+CCAL_PROBE_SEMAPHORE(expr__start);
+CCAL_PROBE_SEMAPHORE(expr__end);
+CCAL_PROBE_SEMAPHORE(parse__error);
+CCAL_PROBE_SEMAPHORE(rules__load);
+CCAL_PROBE_SEMAPHORE(convert);
+
+// Each semaphore is defined once, by the file whose probes use it
+#define CCAL_PROBE_DEFINE(name) \
+    __extension__ unsigned short ccal_##name##_semaphore \
+    __attribute__((unused)) __attribute__((section(".probes")))
+
+#define CCAL_PROBE_ENABLED(name) __builtin_expect(ccal_##name##_semaphore != 0, 0)
+
+#define CCAL_PROBE1(name, a) STAP_PROBE1(ccal, name, a)
+#define CCAL_PROBE2(name, a, b) STAP_PROBE2(ccal, name, a, b)
+#define CCAL_PROBE4(name, a, b, c, d) STAP_PROBE4(ccal, name, a, b, c, d)
+#define CCAL_PROBE5(name, a, b, c, d, e) STAP_PROBE5(ccal, name, a, b, c, d, e)
+
+// Declare var holding the start time of a call, read when probe name is on
+#define CCAL_PROBE_CLOCK(var, name) \
+    uint64_t var = CCAL_PROBE_ENABLED(name) ? ccal_probe_now() : 0
+
+// Nanoseconds since the CCAL_PROBE_CLOCK var, 0 if it was not read
+#define CCAL_PROBE_ELAPSED(var) ((var) ? ccal_probe_now() - (var) : 0)
+
+static inline uint64_t ccal_probe_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static inline int64_t ccal_probe_bits(double value) {
+    int64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+#else
+
+#define CCAL_PROBE1(name, a) ((void)0)
+#define CCAL_PROBE2(name, a, b) ((void)0)
+#define CCAL_PROBE4(name, a, b, c, d) ((void)0)
+#define CCAL_PROBE5(name, a, b, c, d, e) ((void)0)
+#define CCAL_PROBE_CLOCK(var, name) ((void)0)
+
+#endif // CCAL_SDT
+
+#endif // TRACE_H